@@ -97,8 +97,8 @@
 #define TSDB_DATA_TYPE_MAX 20
 #endif
 
-#define REQ_EXTRA_BUF_LEN 1024
 #define RESP_BUF_LEN      4096
+#define BENCH_HTTP_HEADER_LEN 1024
 #define SQL_BUFF_LEN      1024
 
 #define STR_INSERT_INTO "INSERT INTO "
@@ -125,6 +125,8 @@
 #define JSON_BUFF_LEN       20
 #define TIMESTAMP_BUFF_LEN  21
 #define PRINT_STAT_INTERVAL 30 * 1000
+// seconds between live progress lines when report_interval is unset
+#define LIVE_REPORT_INTERVAL 10
 
 #define MAX_QUERY_SQL_COUNT 100
 
@@ -146,6 +148,8 @@
 #define DEFAULT_BINWIDTH       64
 #define DEFAULT_PREPARED_RAND  10000
 #define DEFAULT_REQ_PER_REQ    30000
+#define AUTO_REQ_PER_REQ_START 100
+#define AUTO_REQ_PER_REQ_MAX   32768
 #define DEFAULT_INSERT_ROWS    10000
 #define DEFAULT_DISORDER_RANGE 1000
 #define DEFAULT_CREATE_BATCH   10
@@ -169,7 +173,7 @@
 #define BENCH_SUPPLEMENT "Supplementally insert data without create database and table, optional, default is off."
 #define BENCH_START_TIMESTAMP "Specify timestamp to insert data. Optional, default is 1500000000000 (2017-07-14 10:40:00.000)."
 #define BENCH_INTERLACE "The number of interlace rows insert into tables, default is 0."
-#define BENCH_BATCH "Number of records in each insert request, default is 30000."
+#define BENCH_BATCH "Number of records in each insert request, default is 30000, \"auto\" tunes it while inserting."
 #define BENCH_TABLE "Number of child tables, default is 10000."
 #define BENCH_ROWS  "Number of records for each table, default is 10000."
 #define BENCH_DATABASE  "Name of database, default is test."
@@ -196,6 +200,17 @@
 #define BENCH_VERSION "Print program version."
 #define BENCH_KEEPTRYING "Keep trying if failed to insert, default is no."
 #define BENCH_TRYING_INTERVAL "Specify interval between keep trying insert. Valid value is a positive number. Only valid when keep trying be enabled."
+#define BENCH_RANDOM_SEED "Seed of the random data generator, the same seed reproduces the same data. Default is derived from current time."
+#define BENCH_TARGET_RATE "Target insert rate in rows per second shared by all threads. Requests are sent on a fixed schedule and latency is measured from the scheduled send time, default is 0 (unlimited)."
+#define BENCH_REPORT_INTERVAL "Interval in seconds of the live insert statistics written as JSON lines to <output file>.jsonl, default is 0 (disabled)."
+#define BENCH_AFFINITY "Placement of worker threads: none, compact (fill one NUMA node first), scatter (round robin over NUMA nodes), numa (bind each thread to a whole node) or a CPU list such as 0-7,16-23. Default is none."
+#define BENCH_PROCESSES "Number of worker processes for insertion, each inserts into its own slice of child tables with the given threads. Default is 1, only supported on Linux."
+
+#ifdef WINDOWS
+#define BENCH_THREAD_LOCAL __declspec(thread)
+#else
+#define BENCH_THREAD_LOCAL __thread
+#endif
 
 #ifdef WEBSOCKET
 #define BENCH_DSN "The dsn to connect the cloud service."
@@ -370,6 +385,8 @@ enum TEST_MODE {
 
 enum enumSYNC_MODE { SYNC_MODE, ASYNC_MODE, MODE_BUT };
 
+enum enumREST_CODEC { REST_CODEC_NONE, REST_CODEC_GZIP, REST_CODEC_DEFLATE };
+
 enum enum_TAOS_INTERFACE {
     TAOSC_IFACE,
     REST_IFACE,
@@ -426,6 +443,65 @@ typedef struct BArray {
     void*    pData;
 } BArray;
 
+typedef struct SBenchArenaChunk_S {
+    struct SBenchArenaChunk_S *next;
+    uint64_t used;
+    uint64_t cap;
+    char     data[];
+} SBenchArenaChunk;
+
+typedef struct SBenchArena_S {
+    SBenchArenaChunk *head;
+    uint64_t          chunkSize;
+    uint64_t          bytes;
+} SBenchArena;
+
+// a csv file mapped read only with the offset of every usable line, the
+// rows are read in place so the file may be larger than memory
+typedef struct SBenchCsv_S {
+    char *    data;
+    uint64_t  size;
+    uint64_t *offsets;
+    uint64_t  rows;
+} SBenchCsv;
+
+#define BENCH_ARENA_CHUNK_SIZE  (4 * 1024 * 1024)
+// tag text of all child tables is kept in memory up to this size,
+// beyond it each table's tags are generated when they are needed
+#define TAG_DATA_BUF_LIMIT      (64 * 1024 * 1024)
+
+// log-linear latency histogram, about 1% precision, fixed memory and
+// mergeable across threads
+#define BENCH_HIST_SUB_BITS   7
+#define BENCH_HIST_SUB_COUNT  (1 << BENCH_HIST_SUB_BITS)
+#define BENCH_HIST_MAX_BITS   40
+#define BENCH_HIST_BUCKETS    \
+    ((BENCH_HIST_MAX_BITS - BENCH_HIST_SUB_BITS + 1) * BENCH_HIST_SUB_COUNT)
+
+typedef struct SBenchHist_S {
+    uint64_t count;
+    int64_t  sum;
+    int64_t  min;
+    int64_t  max;
+    uint64_t counts[BENCH_HIST_BUCKETS];
+} SBenchHist;
+
+typedef struct SBenchHttpResp_S {
+    char *   buf;            // raw header followed by the decoded body
+    int64_t  cap;
+    int64_t  len;
+    int64_t  bodyStart;
+    int64_t  bodyLen;
+    int64_t  contentLength;  // -1 when the response carries none
+    int64_t  scanned;        // parse state while the response arrives
+    int64_t  cursor;
+    int64_t  end;            // first byte after the complete response
+    char *   body;           // NUL terminated, points into buf
+    int32_t  status;
+    bool     chunked;
+    char     saved;          // byte overwritten by the body terminator
+} SBenchHttpResp;
+
 typedef struct {
     uint64_t magic;
     uint64_t custom;
@@ -442,6 +518,34 @@ static const int OFF_CUSTOM     = -3;
 static const int OFF_LEN     = -2;
 static const int OFF_CAP     = -1;
 
+// how the values of a column evolve from row to row, uniform noise
+// defeats delta and xor compression so the others look like real series
+enum enumBENCH_GEN {
+    BENCH_GEN_UNIFORM,
+    BENCH_GEN_RANDOM_WALK,  // previous value plus up to +-step
+    BENCH_GEN_SINE,         // sine over period rows plus +-noise
+    BENCH_GEN_COUNTER,      // min, min + step, ... wrapping at max
+    BENCH_GEN_RARE_CHANGE,  // constant, jumps with probability change
+    BENCH_GEN_ZIPF,         // category rank drawn with weight 1/(r+1)^s
+};
+
+typedef struct SBenchGen_S {
+    uint8_t  kind;
+    double   step;
+    double   period;
+    double   noise;
+    double   change;
+    double   zipfS;
+    int32_t  categories;
+    double * zipfCdf;
+} SBenchGen;
+
+// per-call state of the stateful generators
+typedef struct SBenchGenState_S {
+    bool     init;
+    double   last;
+} SBenchGenState;
+
 typedef struct SField {
     uint8_t  type;
     char     name[TSDB_COL_NAME_LEN + 1];
@@ -450,10 +554,13 @@ typedef struct SField {
     bool     null;
     void *   data;
     char *   is_null;
+    int32_t *lengths;
     int64_t  max;
     int64_t  min;
     tools_cJSON *  values;
     bool     sma;
+    SBenchGen gen;
+    double   nullRatio;  // percent of rows written as NULL
 } Field;
 
 typedef struct STSMA {
@@ -476,7 +583,9 @@ typedef struct SSuperTable_S {
     uint64_t childTblCount;
     uint64_t batchCreateTableNum;  // 0: no batch,  > 0: batch table number in
                                    // one sql
+    bool     batchCreateAuto;      // tune the batch from observed latency
     bool     autoCreateTable;
+    bool     stmtTagBind;  // stmt auto-create binds tags per table
     uint16_t iface;  // 0: taosc, 1: rest, 2: stmt
     uint16_t lineProtocol;
     uint64_t childTblLimit;
@@ -500,13 +609,22 @@ typedef struct SSuperTable_S {
     BArray * tags;
     BArray * tsmas;
     char **  childTblName;
+    SBenchArena *childTblNameArena;  // backs the childTblName strings
     char *   colsOfCreateChildTable;
     uint32_t lenOfTags;
     uint32_t lenOfCols;
 
     char *sampleDataBuf;
+    char **sampleNodeBuf;   // copies of sampleDataBuf per numa node
+    SBenchCsv *sampleCsv;   // sample file rows, replaces sampleDataBuf
+    uint64_t sampleRows;    // rows to cycle through before wrapping
+    // rows past prepared_rand mirror the head of the stmt column pool so
+    // a batch of up to this many rows can bind at any offset
+    uint32_t stmtBatchMax;
     bool  useSampleTs;
     char *tagDataBuf;
+    int64_t tagDataRows;  // rows in tagDataBuf, 0 when generated per table
+    SBenchCsv *tagsCsv;   // tags file rows, read per table
     bool  tcpTransfer;
     bool  non_stop;
     char *comment;
@@ -560,7 +678,6 @@ typedef struct SDataBase_S {
 typedef struct SSQL_S {
     char *command;
     char result[MAX_FILE_NAME_LEN];
-    int64_t* delay_list;
 } SSQL;
 
 typedef struct SpecifiedQueryInfo_S {
@@ -643,6 +760,7 @@ typedef struct SArguments_S {
     uint32_t            table_threads;
     uint64_t            prepared_rand;
     uint32_t            reqPerReq;
+    bool                reqPerReqAuto;  // tune reqPerReq, used as ceiling
     uint64_t            insert_interval;
     bool                demo_mode;
     bool                aggr_func;
@@ -672,6 +790,21 @@ typedef struct SArguments_S {
     uint32_t            trying_interval;
     int                 iface;
     int                 rest_server_ver_major;
+    uint64_t            random_seed;
+    int32_t             report_interval;
+    double              target_rate;
+    bool                rate_by_requests;
+    bool                rate_per_thread;
+    bool                pipeline;
+    int32_t             rest_connections;
+    int32_t             rest_depth;
+    int32_t             rest_codec;
+    int32_t             rest_codec_level;
+    bool                dynamic_schedule;
+    int64_t             schedule_chunk;
+    char *              vgroup_cache;
+    int32_t             processes;
+    int32_t             create_depth;
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
     int16_t             inputed_vgroups;
 #endif
@@ -684,20 +817,117 @@ typedef struct SBenchConn{
     WS_TAOS* taos_ws;
     WS_STMT* stmt_ws;
 #endif
+    char  db[TSDB_DB_NAME_LEN];  // database in use, empty when unknown
+    struct SBenchConn *next;     // link in the idle connection pool
 } SBenchConn;
 
+// xoshiro256** state, one per worker thread so data generation never
+// contends on the libc rand() lock
+typedef struct SBenchRand_S {
+    uint64_t s[4];
+} SBenchRand;
+
+// tables of one insert thread, other threads steal from it when they
+// run out of their own
+typedef struct SBenchTableQueue_S {
+    char **          names;
+    int64_t volatile cursor;
+    int64_t          end;
+} SBenchTableQueue;
+
+typedef struct SBenchTableSched_S {
+    SBenchTableQueue *queues;
+    int32_t           size;
+    int64_t           chunk;
+} SBenchTableSched;
+
+// one asynchronous insert in flight per thread, see submitPipelined()
+typedef struct SBenchPipe_S {
+    char *          sql;
+    uint64_t        bytes;
+    TAOS_RES *      res;
+    int32_t         code;
+    int64_t         rows;
+    int64_t         intendedTs;
+    int64_t         startTs;
+    int64_t         endTs;
+    bool            inflight;
+    bool            done;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+} SBenchPipe;
+
+// one REST request owned by the event-driven engine
+typedef struct SBenchRestReq_S {
+    char *   body;
+    uint64_t bodyCap;
+    uint64_t bodyLen;
+    uint64_t rawLen;        // body length before compression
+    uint64_t sent;          // bytes of head and body already written
+    int64_t  rows;
+    int64_t  intendedTs;
+    int64_t  startTs;
+    int64_t  retryUs;       // when a failed request is sent again
+    int32_t  trying;
+    int32_t  headLen;
+    char     head[BENCH_HTTP_HEADER_LEN];
+} SBenchRestReq;
+
+typedef struct SBenchRestConn_S {
+    int            fd;
+    // requests in send order, responses always match the front
+    int32_t *      ring;
+    int32_t        head;
+    int32_t        count;
+    int32_t        written;  // requests at the front fully written
+    int32_t        reconnects;  // since the last response
+    bool           wantWrite;
+    SBenchHttpResp resp;
+} SBenchRestConn;
+
+typedef void (*BenchRestDone)(void *param, SBenchRestReq *req,
+                              int32_t code, int64_t endTs);
+
+typedef struct SBenchRest_S {
+    int             epfd;
+    int32_t         nconn;
+    int32_t         depth;
+    SBenchRestConn *conns;
+    SBenchRestReq * reqs;
+    int32_t *       freeReqs;
+    int32_t         freeCount;
+    int32_t *       retryReqs;  // failed requests waiting for retryUs
+    int32_t         retryCount;
+    int32_t         inflight;
+    int             iface;
+    int             protocol;
+    uint16_t        port;
+    int32_t         trying;
+    uint32_t        tryingInterval;
+    bool            failed;
+    char            url[1024];
+    BenchRestDone   done;
+    void *          param;
+} SBenchRest;
+
 typedef struct SThreadInfo_S {
     SBenchConn* conn;
-    uint64_t * bind_ts;
     uint64_t * bind_ts_array;
     char *     bindParams;
-    char *     is_null;
+    int32_t *  bind_lengths;
+    // tags of the current table for the long-lived auto-create stmt
+    char *     tagBindParams;
+    char *     tagBindBuf;
+    char *     tagBindText;
+    int32_t *  tagBindLengths;
+    char *     tagBindNull;
     uint32_t   threadID;
     uint64_t   start_table_from;
     uint64_t   end_table_to;
     uint64_t   ntables;
     uint64_t   tables_created;
     char *     buffer;
+    uint64_t   bufferSize;  // 0 when buffer is a ds
     uint64_t   counter;
     uint64_t   st;
     uint64_t   et;
@@ -708,19 +938,46 @@ typedef struct SThreadInfo_S {
     uint64_t   querySeq;
     TAOS_SUB * tsub;
     char **    lines;
+    // schemaless lines (or the JSON array) are packed back to back in
+    // buffer, lines[] points into it and lineLen is the packed length
+    uint64_t   lineLen;
+    uint32_t   smlBatchCap;     // rows per request lines and buffer hold
     int32_t    sockfd;
     SDataBase* dbInfo;
     SSuperTable* stbInfo;
-    char **    sml_tags;
-    tools_cJSON *    json_array;
-    tools_cJSON *    sml_json_tags;
+    char *     smlJsonTags;     // JSON tag fragment of smlJsonTagsSeq
+    uint64_t   smlJsonTagsSeq;
+    // interlace mode: per table "name [USING ... TAGS (...)] VALUES "
+    char **    sqlPrefix;
+    uint32_t * sqlPrefixLen;
+    SBenchArena *sqlPrefixArena;  // backs the sqlPrefix strings
     uint64_t   start_time;
     uint64_t   max_sql_len;
     FILE *     fp;
     char       filePath[MAX_PATH_LEN];
-    BArray*    delayList;
-    uint64_t*  query_delay_list;
+    SBenchHist* delayHist;
     double     avg_delay;
+    SBenchRand rand;
+    // counters sampled by the interval reporter, updated atomically
+    int64_t volatile statRows;
+    int64_t volatile statRequests;
+    int64_t volatile statBytes;
+    int64_t volatile statWireBytes;  // bytes on the wire after compression
+    int64_t volatile statErrors;
+    SBenchHist*      statHist;  // cumulative, recorded without a lock
+    // open-loop schedule: request n is due at rateStartUs + n * rateUnitUs,
+    // the start and count are shared unless the rate is per thread
+    int64_t    rateStartUs;
+    double     rateUnitUs;
+    uint64_t   rateUnits;
+    SBenchPipe* pipe;
+    SBenchRest* rest;
+    SBenchTableSched* sched;
+    char **    claimNames;
+    uint64_t   claimNext;
+    uint64_t   claimEnd;
+    uint64_t   tablesStolen;
+    int64_t    finishUs;
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
     SVGroup   *vg;
 #endif
@@ -730,7 +987,7 @@ typedef struct SQueryThreadInfo_S {
     int start_sql;
     int end_sql;
     int threadId;
-    BArray*  query_delay_list;
+    SBenchHist* query_delay_hist;
     int   sockfd;
     SBenchConn* conn;
     int64_t total_delay;
@@ -755,6 +1012,9 @@ extern tools_cJSON *  root;
 extern uint64_t       g_memoryUsage;
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
 #define BARRAY_GET_ELEM(array, index) ((void*)((char*)((array)->pData) + (index) * (array)->elemSize))
 /* ************ Function declares ************  */
 /* benchCommandOpt.c */
@@ -774,20 +1034,32 @@ void    resetAfterAnsiEscape(void);
 char *  convertDatatypeToString(int type);
 int     convertStringToDatatype(char *type, int length);
 unsigned int     taosRandom();
+void    benchRandSeed(SBenchRand *r, uint64_t seed, uint64_t stream);
+SBenchRand *benchRandBind(SBenchRand *r);
+void    benchRandSetStream(uint64_t stream);
+uint64_t benchRandNext(SBenchRand *r);
 void    tmfree(void *buf);
 void    tmfclose(FILE *fp);
 void    fetchResult(TAOS_RES *res, threadInfo *pThreadInfo);
 void    prompt(bool NonStopMode);
 void    ERROR_EXIT(const char *msg);
 int     getServerVersionRest(int16_t rest_port);
-int     postProceSql(char *sqlstr, char* dbName, int precision, int iface,
-                    int protocol, uint16_t rest_port, bool tcp,
-                    int sockfd, char* filePath);
+int     postProceSql(char *sqlstr, uint64_t len, char* dbName,
+                    int precision, int iface, int protocol,
+                    uint16_t rest_port, bool tcp, int sockfd,
+                    char* filePath);
+void    benchRestUrl(char *url, char* dbName, int precision, int iface,
+                     int protocol);
+int32_t benchRestCheckResp(SBenchHttpResp *resp, int iface, int protocol);
 int     queryDbExec(SBenchConn *conn, char *command);
 int     queryDbExecRest(char *command, char* dbName, int precision,
                     int iface, int protocol, bool tcp, int sockfd);
 SBenchConn* init_bench_conn();
 void    close_bench_conn(SBenchConn* conn);
+void    drop_bench_conn(SBenchConn* conn);
+int32_t benchSelectDb(SBenchConn *conn, const char *dbName);
+int32_t benchConnPoolWarmup(int32_t count);
+void    benchConnPoolDestroy();
 int     regexMatch(const char *s, const char *reg, int cflags);
 int     convertHostToServAddr(char *host, uint16_t port,
                               struct sockaddr_in *serv_addr);
@@ -801,6 +1073,24 @@ void* benchArrayDestroy(BArray* pArray);
 void benchArrayClear(BArray* pArray);
 void* benchArrayGet(const BArray* pArray, size_t index);
 void* benchArrayAddBatch(BArray* pArray, void* pData, int32_t elems);
+SBenchArena *benchArenaInit(uint64_t chunkSize);
+char *benchArenaAlloc(SBenchArena *arena, uint64_t size);
+char *benchArenaStrndup(SBenchArena *arena, const char *s, uint64_t len);
+void benchArenaDestroy(SBenchArena *arena);
+void benchBindThread(int32_t seq);
+void benchGenInitZipf(SBenchGen *gen);
+double benchGenNext(Field *field, SBenchGenState *st, int64_t row);
+int64_t benchGetMonotonicUs();
+void benchSleepUntilUs(int64_t deadline);
+SBenchHist* benchHistInit();
+void benchHistReset(SBenchHist* hist);
+void* benchHistDestroy(SBenchHist* hist);
+void benchHistRecord(SBenchHist* hist, int64_t value);
+void benchHistMerge(SBenchHist* dst, const SBenchHist* src);
+void benchHistRecordAtomic(SBenchHist* hist, int64_t value);
+void benchHistMergeDelta(SBenchHist* dst, SBenchHist* cur, SBenchHist* prev);
+int64_t benchHistPercentile(const SBenchHist* hist, double percentile);
+double benchHistMean(const SBenchHist* hist);
 
 #ifdef LINUX
 int32_t bsem_wait(sem_t* sem);
@@ -818,6 +1108,7 @@ int is_ds(const char* s);
 uint64_t ds_custom(const char* s);
 void ds_set_custom(char* s, uint64_t custom);
 uint64_t ds_len(const char* s);
+void ds_clear(char* s);
 uint64_t ds_cap(const char* s);
 int ds_last(char* s);
 char* ds_end(char* s);
@@ -826,6 +1117,7 @@ char* ds_resize(char** ps, size_t cap);
 char * ds_pack(char **ps);
 char * ds_add_char(char **ps, char c);
 char * ds_add_str(char **ps, const char* sub);
+char * ds_add_strn(char **ps, const char* sub, size_t len);
 char * ds_add_strs(char **ps, int count, ...);
 char * ds_ins_str(char **ps, size_t pos, const char *sub, size_t len);
 
@@ -837,6 +1129,35 @@ int convertServAddr(int iface, bool tcp, int protocol);
 int createSockFd();
 void destroySockFd(int sockfd);
 
+// http client
+int32_t benchHttpSend(int sockfd, const char *data, uint64_t len);
+int32_t benchHttpReserve(SBenchHttpResp *resp, uint64_t limit);
+int32_t benchHttpParse(SBenchHttpResp *resp);
+void benchHttpNext(SBenchHttpResp *resp);
+void benchHttpFree(SBenchHttpResp *resp);
+int benchHttpHeader(char *head, int size, const char *url, uint16_t port,
+                    uint64_t bodyLen, const char *encoding);
+const char *benchHttpEncoding();
+int64_t benchHttpCompress(const char *body, uint64_t len,
+                          char **out, uint64_t *cap);
+uint64_t benchHttpLastWireLen();
+SBenchHttpResp *benchHttpRecv(int sockfd, uint64_t limit);
+SBenchHttpResp *benchHttpPost(int sockfd, const char *url, uint16_t port,
+                              const char *body, uint64_t bodyLen,
+                              uint64_t limit);
+void benchHttpRelease();
+
+// event-driven REST engine
+SBenchRest *benchRestInit(int32_t nconn, int32_t depth, char *dbName,
+                          int precision, int iface, int protocol,
+                          uint16_t port, int32_t trying,
+                          uint32_t tryingInterval,
+                          BenchRestDone done, void *param);
+int32_t benchRestSubmit(SBenchRest *rest, const char *body, uint64_t len,
+                        int64_t rows, int64_t intendedTs);
+int32_t benchRestDrain(SBenchRest *rest);
+void benchRestDestroy(SBenchRest *rest);
+
 void printVersion();
 int32_t benchParseSingleOpt(int32_t key, char* arg);
 
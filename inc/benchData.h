@@ -24,11 +24,24 @@ int64_t getTSRandTail(int64_t timeStampStep, int32_t seq, int disorderRatio,
 int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                          int lenOfOneRow, BArray * fields, int64_t loop,
                          bool tag);
+SBenchCsv *benchCsvOpen(const char *file, int32_t maxLen);
+char   *benchCsvRow(SBenchCsv *csv, uint64_t row, int32_t *len);
+void    benchCsvClose(SBenchCsv *csv);
+char   *getSampleRow(SSuperTable *stbInfo, uint64_t pos, int32_t *len);
+void    localizeSampleData(SSuperTable *stbInfo);
+char   *getTagData(SSuperTable *stbInfo, uint64_t tableSeq);
+void    releaseTagData();
 int     prepareStmt(SSuperTable *stbInfo, TAOS_STMT *stmt, uint64_t tableSeq);
+void    prepareStmtBind(threadInfo *pThreadInfo);
+bool    stmtTagsBindable(SSuperTable *stbInfo);
+int     setStmtTbnameTags(threadInfo *pThreadInfo, uint64_t tableSeq,
+                          char *tableName);
 uint32_t bindParamBatch(threadInfo *pThreadInfo, uint32_t batch, int64_t startTime);
 int prepareSampleData(SDataBase* database, SSuperTable* stbInfo);
-void generateSmlJsonTags(tools_cJSON *tagsList, SSuperTable *stbInfo,
-                            uint64_t start_table_from, int tbSeq);
-void generateSmlJsonCols(tools_cJSON *array, tools_cJSON *tag, SSuperTable *stbInfo,
-                            uint32_t time_precision, int64_t timestamp);
+char *generateSmlJsonTags(SSuperTable *stbInfo,
+                          uint64_t start_table_from, int tbSeq);
+uint64_t smlJsonTagsLen(SSuperTable *stbInfo);
+uint64_t smlJsonColsLen(SSuperTable *stbInfo);
+int generateSmlJsonCols(char *buf, const char *tag, SSuperTable *stbInfo,
+                        uint32_t time_precision, int64_t timestamp);
 #endif
@@ -232,4 +232,22 @@ void errorPrintReqArg2(char *program, char *wrong_arg);
 void errorPrintReqArg3(char *program, char *wrong_arg);
 int setConsoleEcho(bool on);
 
+// worker thread placement, see toolsBindThread()
+#define TOOLS_MAX_CPUS      1024
+#define TOOLS_MAX_NODES     64
+
+enum {
+    TOOLS_AFFINITY_NONE,
+    TOOLS_AFFINITY_COMPACT,
+    TOOLS_AFFINITY_SCATTER,
+    TOOLS_AFFINITY_NUMA,
+    TOOLS_AFFINITY_LIST
+};
+
+int32_t toolsSetAffinity(const char *spec);
+int32_t toolsBindThread(int32_t seq);
+int32_t toolsThreadNode();
+int32_t toolsNumaNodes();
+void    toolsMoveToLocalNode(void *ptr, size_t len);
+
 #endif // __TOOLSDEF_H_
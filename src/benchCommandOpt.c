@@ -266,6 +266,11 @@ int32_t benchParseSingleOpt(int32_t key, char* arg) {
             break;
 
         case 'r':
+            if (0 == strcasecmp(arg, "auto")) {
+                g_arguments->reqPerReqAuto = true;
+                g_arguments->reqPerReq = AUTO_REQ_PER_REQ_MAX;
+                break;
+            }
             if (!toolsIsStringNumber(arg)) {
                 errorPrintReqArg2("taosBenchmark", "r");
             }
@@ -487,6 +492,53 @@ int32_t benchParseSingleOpt(int32_t key, char* arg) {
             benchArrayPush(database->cfgs, cfg);
             break;
         }
+        case 'X':
+            if (!toolsIsStringNumber(arg)) {
+                errorPrintReqArg2("taosBenchmark", "X");
+            }
+
+            g_arguments->random_seed = strtoull(arg, NULL, 10);
+            break;
+
+        case 'j':
+            if (!toolsIsStringNumber(arg)) {
+                errorPrintReqArg2("taosBenchmark", "j");
+            }
+
+            g_arguments->report_interval = atoi(arg);
+            break;
+
+        case 'Q': {
+            // the rate may be fractional, e.g. -Q 0.5 for one row per 2s
+            char *end = NULL;
+            double rate = strtod(arg, &end);
+            if (end == arg || *end != '\0' || rate <= 0) {
+                errorPrintReqArg2("taosBenchmark", "Q");
+                exit(EXIT_FAILURE);
+            }
+
+            g_arguments->target_rate = rate;
+            break;
+        }
+
+        case 'K':
+            if (toolsSetAffinity(arg)) {
+                errorWrongValue("taosBenchmark", "-K", arg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case 'Z':
+            if (!toolsIsStringNumber(arg)) {
+                errorPrintReqArg2("taosBenchmark", "Z");
+            }
+
+            g_arguments->processes = atoi(arg);
+            if (g_arguments->processes < 1) {
+                errorPrintReqArg2("taosBenchmark", "Z");
+            }
+            break;
+
         case 'g':
             g_arguments->debug_print = true;
             break;
@@ -576,6 +628,11 @@ static struct argp_option bench_options[] = {
 #endif
     {"keep-trying", 'k', "NUMBER", 0, BENCH_KEEPTRYING},
     {"trying-interval", 'z', "NUMBER", 0, BENCH_TRYING_INTERVAL},
+    {"random-seed", 'X', "NUMBER", 0, BENCH_RANDOM_SEED},
+    {"report-interval", 'j', "SECONDS", 0, BENCH_REPORT_INTERVAL},
+    {"target-rate", 'Q', "NUMBER", 0, BENCH_TARGET_RATE},
+    {"processes", 'Z', "NUMBER", 0, BENCH_PROCESSES},
+    {"affinity", 'K', "POLICY", 0, BENCH_AFFINITY},
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
     {"vgroups", 'v', "NUMBER", 0, BENCH_VGROUPS},
 #endif
@@ -743,6 +800,21 @@ void init_argument() {
     g_arguments->trying_interval = 0;
     g_arguments->iface = TAOSC_IFACE;
     g_arguments->rest_server_ver_major = -1;
+    g_arguments->random_seed = (uint64_t)toolsGetTimestampNs();
+    g_arguments->report_interval = 0;
+    g_arguments->target_rate = 0;
+    g_arguments->rate_by_requests = false;
+    g_arguments->rate_per_thread = false;
+    g_arguments->pipeline = false;
+    g_arguments->rest_connections = 0;
+    g_arguments->rest_depth = 1;
+    g_arguments->rest_codec = REST_CODEC_NONE;
+    g_arguments->rest_codec_level = 6;
+    g_arguments->dynamic_schedule = false;
+    g_arguments->schedule_chunk = 0;
+    g_arguments->vgroup_cache = NULL;
+    g_arguments->processes = 1;
+    g_arguments->create_depth = 1;
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
     g_arguments->inputed_vgroups = -1;
 #endif
@@ -906,7 +978,8 @@ static void *queryStableAggrFunc(void *sarg) {
             double t = (double)toolsGetTimestampUs();
             int32_t code = -1;
             if (REST_IFACE == g_arguments->iface) {
-                code = postProceSql(command, NULL, 0, REST_IFACE,
+                code = postProceSql(command, strlen(command), NULL, 0,
+                                    REST_IFACE,
                                     0, g_arguments->port, 0,
                                     pThreadInfo->sockfd, NULL);
             } else {
@@ -985,7 +1058,8 @@ static void *queryNtableAggrFunc(void *sarg) {
             double    t = (double)toolsGetTimestampUs();
             int32_t code = -1;
             if (REST_IFACE == g_arguments->iface) {
-                code = postProceSql(command, NULL, 0, REST_IFACE,
+                code = postProceSql(command, strlen(command), NULL, 0,
+                                    REST_IFACE,
                                     0, g_arguments->port, 0,
                                     pThreadInfo->sockfd, NULL);
             } else {
@@ -10,6 +10,7 @@
  * FITNESS FOR A PARTICULAR PURPOSE.
  */
 
+#include <math.h>
 #include "benchData.h"
 #include "bench.h"
 
@@ -104,6 +105,48 @@ static void rand_string(char *str, int size, bool chinese) {
     }
 }
 
+static BENCH_THREAD_LOCAL char *  g_tagBuf;
+static BENCH_THREAD_LOCAL uint32_t g_tagBufLen;
+
+// Tag text of child table tableSeq. Tables past the in-memory rows get
+// their tags generated from a random stream of their own, so the same
+// table always gets the same tags no matter which thread asks. The
+// returned text is only valid until the next call in the same thread.
+char *getTagData(SSuperTable *stbInfo, uint64_t tableSeq) {
+    if (stbInfo->tagDataRows > 0) {
+        return stbInfo->tagDataBuf
+            + stbInfo->lenOfTags * (tableSeq % stbInfo->tagDataRows);
+    }
+    if (g_tagBufLen < stbInfo->lenOfTags + 1) {
+        tmfree(g_tagBuf);
+        g_tagBuf = benchCalloc(1, stbInfo->lenOfTags + 1, false);
+        g_tagBufLen = stbInfo->lenOfTags + 1;
+    }
+    if (stbInfo->tagsCsv) {
+        int32_t len;
+        char *  row = benchCsvRow(stbInfo->tagsCsv,
+                                  tableSeq % stbInfo->tagsCsv->rows, &len);
+        memcpy(g_tagBuf, row, len);
+        g_tagBuf[len] = '\0';
+        return g_tagBuf;
+    }
+    SBenchRand rand;
+    benchRandSeed(&rand, g_arguments->random_seed,
+                  ((uint64_t)2 << 32) + tableSeq);
+    SBenchRand *prev = benchRandBind(&rand);
+    memset(g_tagBuf, 0, stbInfo->lenOfTags);
+    generateRandData(stbInfo, g_tagBuf, stbInfo->lenOfTags,
+                     stbInfo->tags, 1, true);
+    benchRandBind(prev);
+    return g_tagBuf;
+}
+
+void releaseTagData() {
+    tmfree(g_tagBuf);
+    g_tagBuf = NULL;
+    g_tagBufLen = 0;
+}
+
 int prepareStmt(SSuperTable *stbInfo, TAOS_STMT *stmt, uint64_t tableSeq) {
     int   len = 0;
     char *prepare = benchCalloc(1, BUFFER_SIZE, true);
@@ -112,11 +155,22 @@ int prepareStmt(SSuperTable *stbInfo, TAOS_STMT *stmt, uint64_t tableSeq) {
         if (stbInfo->ttl != 0) {
             sprintf(ttl, "TTL %d", stbInfo->ttl);
         }
-        len += sprintf(prepare + len,
-                       "INSERT INTO ? USING `%s` TAGS (%s) %s VALUES(?",
-                       stbInfo->stbName,
-                       stbInfo->tagDataBuf + stbInfo->lenOfTags * tableSeq,
-                       ttl);
+        if (stbInfo->stmtTagBind) {
+            // tags are bound per table, see setStmtTbnameTags()
+            len += sprintf(prepare + len,
+                           "INSERT INTO ? USING `%s` TAGS (?",
+                           stbInfo->stbName);
+            for (int t = 1; t < stbInfo->tags->size; t++) {
+                len += sprintf(prepare + len, ",?");
+            }
+            len += sprintf(prepare + len, ") %s VALUES(?", ttl);
+        } else {
+            len += sprintf(prepare + len,
+                           "INSERT INTO ? USING `%s` TAGS (%s) %s VALUES(?",
+                           stbInfo->stbName,
+                           getTagData(stbInfo, tableSeq),
+                           ttl);
+        }
     } else {
         len += sprintf(prepare + len, "INSERT INTO ? VALUES(?");
     }
@@ -125,7 +179,13 @@ int prepareStmt(SSuperTable *stbInfo, TAOS_STMT *stmt, uint64_t tableSeq) {
         len += sprintf(prepare + len, ",?");
     }
     sprintf(prepare + len, ")");
-    if (g_arguments->prepared_rand < g_arguments->reqPerReq) {
+    if (g_arguments->prepared_rand < g_arguments->reqPerReq
+            && g_arguments->reqPerReqAuto) {
+        infoPrint("in stmt mode, auto batch size is tuned up to prepared "
+                  "sample data size(%" PRId64 ")\n",
+                  g_arguments->prepared_rand);
+        g_arguments->reqPerReq = g_arguments->prepared_rand;
+    } else if (g_arguments->prepared_rand < g_arguments->reqPerReq) {
         infoPrint(
                   "in stmt mode, batch size(%u) can not larger than prepared "
                   "sample data size(%" PRId64
@@ -144,90 +204,175 @@ int prepareStmt(SSuperTable *stbInfo, TAOS_STMT *stmt, uint64_t tableSeq) {
     return 0;
 }
 
-static int generateSampleFromCsvForStb(char *buffer, char *file, int32_t length,
-                                       int64_t size) {
-    size_t  n = 0;
-    char *  line = NULL;
-    int     getRows = 0;
+#ifndef WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
-    FILE *fp = fopen(file, "r");
-    if (fp == NULL) {
+// Map file and index the start of every non empty line no longer than
+// maxLen in one pass. Nothing is copied, rows are read straight from the
+// mapping, which the kernel pages in and out as the replay moves along.
+SBenchCsv *benchCsvOpen(const char *file, int32_t maxLen) {
+    SBenchCsv *csv = benchCalloc(1, sizeof(SBenchCsv), true);
+#ifdef WINDOWS
+    FILE *fp = fopen(file, "rb");
+    if (NULL == fp) {
         errorPrint("Failed to open sample file: %s, reason:%s\n", file,
                    strerror(errno));
-        return -1;
+        tmfree(csv);
+        return NULL;
     }
-    while (1) {
-        ssize_t readLen = 0;
-#if defined(WIN32) || defined(WIN64)
-        toolsGetLineFile(&line, &n, fp);
-        readLen = n;
+    fseek(fp, 0, SEEK_END);
+    csv->size = (uint64_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    csv->data = benchCalloc(1, csv->size + 1, false);
+    if (fread(csv->data, 1, csv->size, fp) != csv->size) {
+        errorPrint("Failed to read sample file: %s\n", file);
+        fclose(fp);
+        benchCsvClose(csv);
+        return NULL;
+    }
+    fclose(fp);
 #else
-        readLen = getline(&line, &n, fp);
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        errorPrint("Failed to open sample file: %s, reason:%s\n", file,
+                   strerror(errno));
+        tmfree(csv);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) || 0 == st.st_size) {
+        errorPrint("sample file %s is empty or can not be read\n", file);
+        close(fd);
+        tmfree(csv);
+        return NULL;
+    }
+    csv->size = (uint64_t)st.st_size;
+    csv->data = mmap(NULL, csv->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == csv->data) {
+        errorPrint("Failed to map sample file: %s, reason:%s\n", file,
+                   strerror(errno));
+        csv->data = NULL;
+        tmfree(csv);
+        return NULL;
+    }
+    madvise(csv->data, csv->size, MADV_SEQUENTIAL);
 #endif
-        if (-1 == readLen) {
-            if (0 != fseek(fp, 0, SEEK_SET)) {
-                errorPrint("Failed to fseek file: %s, reason:%s\n",
-                        file, strerror(errno));
-                fclose(fp);
-                return -1;
-            }
-            continue;
-        }
-
-        if (('\r' == line[readLen - 1]) || ('\n' == line[readLen - 1])) {
-            line[--readLen] = 0;
-        }
-
-        if (readLen == 0) {
-            continue;
-        }
 
-        if (readLen > length) {
-            infoPrint(
-                "sample row len[%d] overflow define schema len[%d], so discard "
-                "this row\n",
-                (int32_t)readLen, length);
-            continue;
+    uint64_t cap = 1024;
+    uint64_t discarded = 0;
+    csv->offsets = benchCalloc(cap, sizeof(uint64_t), false);
+    for (uint64_t off = 0; off < csv->size;) {
+        char *   start = csv->data + off;
+        char *   nl = memchr(start, '\n', csv->size - off);
+        uint64_t len = nl ? (uint64_t)(nl - start) : csv->size - off;
+        uint64_t next = off + len + 1;
+        if (len > 0 && '\r' == start[len - 1]) {
+            len--;
         }
-
-        memcpy(buffer + getRows * length, line, readLen);
-        getRows++;
-
-        if (getRows == size) {
-            break;
+        if (len > (uint64_t)maxLen) {
+            discarded++;
+        } else if (len > 0) {
+            if (csv->rows == cap) {
+                cap *= 2;
+                uint64_t *offsets = realloc(csv->offsets,
+                                            cap * sizeof(uint64_t));
+                if (NULL == offsets) {
+                    errorPrint("%s", "failed to allocate memory\n");
+                    exit(EXIT_FAILURE);
+                }
+                csv->offsets = offsets;
+            }
+            csv->offsets[csv->rows++] = off;
         }
+        off = next;
+    }
+#ifndef WINDOWS
+    madvise(csv->data, csv->size, MADV_NORMAL);
+#endif
+    if (discarded) {
+        infoPrint("%" PRIu64 " rows of %s are longer than the schema "
+                  "length %d and discarded\n", discarded, file, maxLen);
     }
+    if (0 == csv->rows) {
+        errorPrint("no usable row in sample file %s\n", file);
+        benchCsvClose(csv);
+        return NULL;
+    }
+    infoPrint("indexed %" PRIu64 " rows of %s (%" PRIu64 " bytes)\n",
+              csv->rows, file, csv->size);
+    return csv;
+}
 
-    fclose(fp);
-    tmfree(line);
-    return 0;
+char *benchCsvRow(SBenchCsv *csv, uint64_t row, int32_t *len) {
+    uint64_t off = csv->offsets[row];
+    char *   start = csv->data + off;
+    char *   nl = memchr(start, '\n', csv->size - off);
+    int32_t  n = nl ? (int32_t)(nl - start) : (int32_t)(csv->size - off);
+    if (n > 0 && '\r' == start[n - 1]) {
+        n--;
+    }
+    *len = n;
+    return start;
 }
 
-static int getAndSetRowsFromCsvFile(SSuperTable *stbInfo) {
-    FILE *  fp = fopen(stbInfo->sampleFile, "r");
-    if (NULL == fp) {
-        errorPrint("Failed to open sample file: %s, reason:%s\n",
-                   stbInfo->sampleFile, strerror(errno));
-        return -1;
+void benchCsvClose(SBenchCsv *csv) {
+    if (NULL == csv) {
+        return;
+    }
+#ifdef WINDOWS
+    tmfree(csv->data);
+#else
+    if (csv->data) {
+        munmap(csv->data, csv->size);
     }
+#endif
+    tmfree(csv->offsets);
+    tmfree(csv);
+}
 
-    int     line_count = 0;
-    char *  buf = NULL;
+static pthread_mutex_t g_sampleNodeLock = PTHREAD_MUTEX_INITIALIZER;
 
-    buf = benchCalloc(1, TSDB_MAX_SQL_LEN, false);
-    if (NULL == buf) {
-        errorPrint("%s() failed to allocate memory!\n", __func__);
-        fclose(fp);
-        return -1;
+// give each numa node its own copy of the sample rows, made by the first
+// writer placed on the node, so that rows are read from local memory
+void localizeSampleData(SSuperTable *stbInfo) {
+    int32_t node = toolsThreadNode();
+    if (node < 0 || toolsNumaNodes() < 2 || NULL == stbInfo->sampleDataBuf) {
+        return;
     }
+    pthread_mutex_lock(&g_sampleNodeLock);
+    if (NULL == stbInfo->sampleNodeBuf) {
+        stbInfo->sampleNodeBuf =
+            benchCalloc(TOOLS_MAX_NODES, sizeof(char *), true);
+    }
+    if (NULL == stbInfo->sampleNodeBuf[node]) {
+        uint64_t size = (uint64_t)stbInfo->lenOfCols * stbInfo->sampleRows;
+        char *   buf = benchCalloc(1, size, true);
+        toolsMoveToLocalNode(buf, size);
+        memcpy(buf, stbInfo->sampleDataBuf, size);
+        stbInfo->sampleNodeBuf[node] = buf;
+    }
+    pthread_mutex_unlock(&g_sampleNodeLock);
+}
 
-    while (fgets(buf, TSDB_MAX_SQL_LEN, fp)) {
-        line_count++;
+// text of sample row pos, which is not NUL terminated when it comes from
+// the mapped sample file
+char *getSampleRow(SSuperTable *stbInfo, uint64_t pos, int32_t *len) {
+    if (stbInfo->sampleCsv) {
+        return benchCsvRow(stbInfo->sampleCsv, pos, len);
     }
-    stbInfo->insertRows = line_count;
-    fclose(fp);
-    tmfree(buf);
-    return 0;
+    char *  buf = stbInfo->sampleDataBuf;
+    int32_t node = toolsThreadNode();
+    if (node >= 0 && stbInfo->sampleNodeBuf
+            && stbInfo->sampleNodeBuf[node]) {
+        buf = stbInfo->sampleNodeBuf[node];
+    }
+    char *row = buf + stbInfo->lenOfCols * pos;
+    *len = (int32_t)strlen(row);
+    return row;
 }
 
 static uint32_t calcRowLen(BArray *fields, int iface) {
@@ -290,22 +435,159 @@ static uint32_t calcRowLen(BArray *fields, int iface) {
     return ret;
 }
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// uniform in [0, 1)
+static double benchGenUniform() {
+    return taosRandom() / 2147483648.0;
+}
+
+void benchGenInitZipf(SBenchGen *gen) {
+    gen->zipfCdf = benchCalloc(gen->categories, sizeof(double), true);
+    double sum = 0;
+    for (int32_t r = 0; r < gen->categories; r++) {
+        sum += 1.0 / pow(r + 1, gen->zipfS);
+        gen->zipfCdf[r] = sum;
+    }
+    for (int32_t r = 0; r < gen->categories; r++) {
+        gen->zipfCdf[r] /= sum;
+    }
+}
+
+static int32_t benchGenZipfRank(SBenchGen *gen) {
+    double  u = benchGenUniform();
+    int32_t lo = 0, hi = gen->categories - 1;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (gen->zipfCdf[mid] < u) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// next value of a generated column for row, within [min, max]
+double benchGenNext(Field *field, SBenchGenState *st, int64_t row) {
+    SBenchGen *gen = &field->gen;
+    double     lo = (double)field->min;
+    double     hi = (double)field->max;
+    double     span = hi - lo;
+    double     v;
+    switch (gen->kind) {
+        case BENCH_GEN_RANDOM_WALK:
+            if (!st->init) {
+                st->last = lo + span / 2;
+                st->init = true;
+            }
+            v = st->last + (2 * benchGenUniform() - 1) * gen->step;
+            // reflect at the bounds instead of sticking to them
+            if (v < lo) {
+                v = lo + (lo - v);
+            }
+            if (v > hi) {
+                v = hi - (v - hi);
+            }
+            st->last = v;
+            break;
+        case BENCH_GEN_SINE:
+            v = lo + span / 2
+                + span / 2 * sin(2 * M_PI * (double)row / gen->period)
+                + gen->noise * (2 * benchGenUniform() - 1);
+            break;
+        case BENCH_GEN_COUNTER:
+            v = span > 0 ? lo + fmod((double)row * gen->step, span) : lo;
+            break;
+        case BENCH_GEN_RARE_CHANGE:
+            if (!st->init || benchGenUniform() < gen->change) {
+                st->last = lo + benchGenUniform() * span;
+                st->init = true;
+            }
+            v = st->last;
+            break;
+        case BENCH_GEN_ZIPF:
+            v = lo + benchGenZipfRank(gen);
+            break;
+        default:
+            v = lo + benchGenUniform() * span;
+            break;
+    }
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// text of a category drawn for binary and nchar columns
+static void benchGenCategory(Field *field, double v, char *str, int size) {
+    int32_t rank = (int32_t)(v - (double)field->min);
+    int     n = field->values ? tools_cJSON_GetArraySize(field->values) : 0;
+    if (n > 0) {
+        tools_cJSON *item = tools_cJSON_GetArrayItem(field->values, rank % n);
+        snprintf(str, size, "%s", item->valuestring);
+    } else {
+        snprintf(str, size, "cat%d", rank);
+    }
+}
+
+// write generated value v of field in the row format of iface, returns
+// the length written including the trailing separator
+static int formatGenValue(char *buf, Field *field, double v, int iface,
+                          int line_protocol) {
+    bool        sml = iface == SML_IFACE || iface == SML_REST_IFACE;
+    char        value[TSDB_MAX_BINARY_LEN + 8];
+    const char *suffix = "";
+    switch (field->type) {
+        case TSDB_DATA_TYPE_BOOL:
+            snprintf(value, sizeof(value), "%s",
+                     ((int64_t)v & 1) ? "true" : "false");
+            break;
+        case TSDB_DATA_TYPE_FLOAT:
+        case TSDB_DATA_TYPE_DOUBLE:
+            snprintf(value, sizeof(value), "%f", v);
+            suffix = field->type == TSDB_DATA_TYPE_FLOAT ? "f32" : "f64";
+            break;
+        case TSDB_DATA_TYPE_BINARY:
+        case TSDB_DATA_TYPE_NCHAR: {
+            char category[TSDB_MAX_BINARY_LEN];
+            benchGenCategory(field, v, category,
+                             min((int)field->length + 1, (int)sizeof(category)));
+            snprintf(value, sizeof(value),
+                     !sml ? "'%s'"
+                     : field->type == TSDB_DATA_TYPE_NCHAR ? "L\"%s\""
+                     : "\"%s\"", category);
+            break;
+        }
+        default:
+            snprintf(value, sizeof(value), "%" PRId64, (int64_t)v);
+            switch (field->type) {
+                case TSDB_DATA_TYPE_TINYINT:   suffix = "i8";  break;
+                case TSDB_DATA_TYPE_UTINYINT:  suffix = "u8";  break;
+                case TSDB_DATA_TYPE_SMALLINT:  suffix = "i16"; break;
+                case TSDB_DATA_TYPE_USMALLINT: suffix = "u16"; break;
+                case TSDB_DATA_TYPE_INT:       suffix = "i32"; break;
+                case TSDB_DATA_TYPE_UINT:      suffix = "u32"; break;
+                case TSDB_DATA_TYPE_BIGINT:    suffix = "i64"; break;
+                default:                       suffix = "u64"; break;
+            }
+            break;
+    }
+    if (sml && line_protocol == TSDB_SML_LINE_PROTOCOL) {
+        return sprintf(buf, "%s=%s%s,", field->name, value, suffix);
+    } else if (sml && line_protocol == TSDB_SML_TELNET_PROTOCOL) {
+        return sprintf(buf, "%s%s ", value, suffix);
+    }
+    return sprintf(buf, "%s,", value);
+}
+
 int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                       int lenOfOneRow, BArray * fields, int64_t loop,
                       bool tag) {
     int     iface = stbInfo->iface;
     int     line_protocol = stbInfo->lineProtocol;
-    if (iface == STMT_IFACE) {
-        for (int i = 0; i < fields->size; ++i) {
-            Field * field = benchArrayGet(fields, i);
-            if (field->type == TSDB_DATA_TYPE_BINARY ||
-                    field->type == TSDB_DATA_TYPE_NCHAR) {
-                field->data = benchCalloc(1, loop * (field->length + 1), true);
-            } else {
-                field->data = benchCalloc(1, loop * field->length, true);
-            }
-        }
-    }
+    // column generators carry state from one row to the next
+    SBenchGenState *states = tag ? NULL
+        : benchCalloc(fields->size, sizeof(SBenchGenState), true);
     for (int64_t k = 0; k < loop; ++k) {
         int64_t pos = k * lenOfOneRow;
         if (line_protocol == TSDB_SML_LINE_PROTOCOL &&
@@ -326,13 +608,21 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                     pos += sprintf(sampleDataBuf + pos, "now,");
                     continue;
                 }
+                if (!tag && field->nullRatio > 0
+                        && benchGenUniform() * 100 < field->nullRatio) {
+                    pos += sprintf(sampleDataBuf + pos, "null,");
+                    continue;
+                }
+            }
+            if (!tag && field->gen.kind != BENCH_GEN_UNIFORM) {
+                pos += formatGenValue(sampleDataBuf + pos, field,
+                                      benchGenNext(field, states + i, k),
+                                      iface, line_protocol);
+                continue;
             }
             switch (field->type) {
                 case TSDB_DATA_TYPE_BOOL: {
                     bool rand_bool = (taosRandom() % 2) & 1;
-                    if (iface == STMT_IFACE) {
-                        ((bool *)field->data)[k] = rand_bool;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%s,",
@@ -359,9 +649,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                     int8_t tinyint =
                             field->min +
                         (taosRandom() % (field->max - field->min));
-                    if (iface == STMT_IFACE) {
-                        ((int8_t *)field->data)[k] = tinyint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%di8,",
@@ -384,9 +671,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                 }
                 case TSDB_DATA_TYPE_UTINYINT: {
                     uint8_t utinyint = field->min + (taosRandom() % (field->max - field->min));
-                    if (iface == STMT_IFACE) {
-                        ((uint8_t *)field->data)[k] = utinyint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%uu8,",
@@ -408,9 +692,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                 }
                 case TSDB_DATA_TYPE_SMALLINT: {
                     int16_t smallint = field->min + (taosRandom() % (field->max -field->min));
-                    if (iface == STMT_IFACE) {
-                        ((int16_t *)field->data)[k] = smallint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%di16,",
@@ -434,9 +715,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                 case TSDB_DATA_TYPE_USMALLINT: {
                     uint16_t usmallint = field->min
                         + (taosRandom() % (field->max - field->min));
-                    if (iface == STMT_IFACE) {
-                        ((uint16_t *)field->data)[k] = usmallint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%uu16,",
@@ -473,9 +751,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                         }
                         int_ = field->min + (taosRandom() % (field->max - field->min));
                     }
-                    if (iface == STMT_IFACE) {
-                        ((int32_t *)field->data)[k] = int_;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%di32,",
@@ -498,9 +773,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                 case TSDB_DATA_TYPE_BIGINT: {
                     int64_t _bigint;
                     _bigint = field->min + (taosRandom() % (field->max - field->min));
-                    if (iface == STMT_IFACE) {
-                        ((int64_t *)field->data)[k] = _bigint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%"PRId64"i64,",
@@ -522,9 +794,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                 }
                 case TSDB_DATA_TYPE_UINT: {
                     uint32_t _uint = field->min + (taosRandom() % (field->max - field->min));
-                    if (iface == STMT_IFACE) {
-                        ((uint32_t *)field->data)[k] = _uint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%uu32,",
@@ -549,9 +818,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                     uint64_t _ubigint =
                             field->min +
                         (taosRandom() % (field->max - field->min));
-                    if (iface == STMT_IFACE) {
-                        ((uint64_t *)field->data)[k] = _ubigint;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%"PRIu64"u64,",
@@ -587,9 +853,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                                           _float / 1000000000) /
                                          360);
                     }
-                    if (iface == STMT_IFACE) {
-                        ((float *)(field->data))[k] = _float;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%ff32,",
@@ -616,9 +879,6 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                                  (taosRandom() %
                                   (field->max - field->min)) +
                                  taosRandom() % 1000000 / 1000000.0);
-                    if (iface == STMT_IFACE) {
-                        ((double *)field->data)[k] = double_;
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
                         pos += sprintf(sampleDataBuf + pos, "%s=%ff64,",
@@ -662,16 +922,13 @@ int generateRandData(SSuperTable *stbInfo, char *sampleDataBuf,
                             errorPrint("%s() cannot read correct value from json file. array size: %d\n",
                                     __func__, arraySize);
                             free(tmp);
+                            tmfree(states);
                             return -1;
                         }
                     } else {
                         rand_string(tmp, field->length,
                                     g_arguments->chinese);
                     }
-                    if (iface == STMT_IFACE) {
-                        sprintf((char *)field->data + k * field->length,
-                                "%s", tmp);
-                    }
                     if ((iface == SML_IFACE || iface == SML_REST_IFACE) &&
                             field->type == TSDB_DATA_TYPE_BINARY &&
                         line_protocol == TSDB_SML_LINE_PROTOCOL) {
@@ -731,6 +988,393 @@ skip:
         *(sampleDataBuf + pos - 1) = 0;
     }
 
+    tmfree(states);
+    return 0;
+}
+
+typedef struct SStmtPoolWorker_S {
+    SSuperTable *stbInfo;
+    int64_t      from;
+    int64_t      to;
+    int32_t      seq;
+    pthread_t    pid;
+} SStmtPoolWorker;
+
+// store generated value v of field into row k of the typed pool
+static void storeGenValue(Field *field, int64_t k, double v, char *tmp) {
+    switch (field->type) {
+        case TSDB_DATA_TYPE_BOOL:
+            ((bool *)field->data)[k] = (int64_t)v & 1;
+            break;
+        case TSDB_DATA_TYPE_TINYINT:
+            ((int8_t *)field->data)[k] = (int8_t)v;
+            break;
+        case TSDB_DATA_TYPE_UTINYINT:
+            ((uint8_t *)field->data)[k] = (uint8_t)v;
+            break;
+        case TSDB_DATA_TYPE_SMALLINT:
+            ((int16_t *)field->data)[k] = (int16_t)v;
+            break;
+        case TSDB_DATA_TYPE_USMALLINT:
+            ((uint16_t *)field->data)[k] = (uint16_t)v;
+            break;
+        case TSDB_DATA_TYPE_INT:
+            ((int32_t *)field->data)[k] = (int32_t)v;
+            break;
+        case TSDB_DATA_TYPE_UINT:
+            ((uint32_t *)field->data)[k] = (uint32_t)v;
+            break;
+        case TSDB_DATA_TYPE_BIGINT:
+            ((int64_t *)field->data)[k] = (int64_t)v;
+            break;
+        case TSDB_DATA_TYPE_UBIGINT:
+            ((uint64_t *)field->data)[k] = (uint64_t)v;
+            break;
+        case TSDB_DATA_TYPE_FLOAT:
+            ((float *)field->data)[k] = (float)v;
+            break;
+        case TSDB_DATA_TYPE_DOUBLE:
+            ((double *)field->data)[k] = v;
+            break;
+        case TSDB_DATA_TYPE_BINARY:
+        case TSDB_DATA_TYPE_NCHAR:
+            benchGenCategory(field, v, tmp, field->length + 1);
+            strncpy((char *)field->data + k * field->length, tmp,
+                    field->length);
+            break;
+        default:
+            break;
+    }
+}
+
+static void fillStmtColumn(Field *field, int colIndex,
+                           int64_t from, int64_t to) {
+    char *tmp = benchCalloc(1, field->length + 1, false);
+    // each worker walks its own slice of the pool
+    SBenchGenState state = {0};
+    for (int64_t k = from; k < to; k++) {
+        if (field->null) {
+            field->is_null[k] = true;
+            continue;
+        }
+        if (field->nullRatio > 0
+                && benchGenUniform() * 100 < field->nullRatio) {
+            field->is_null[k] = true;
+            continue;
+        }
+        if (field->gen.kind != BENCH_GEN_UNIFORM) {
+            storeGenValue(field, k, benchGenNext(field, &state, k), tmp);
+            continue;
+        }
+        switch (field->type) {
+            case TSDB_DATA_TYPE_BOOL:
+                ((bool *)field->data)[k] = (taosRandom() % 2) & 1;
+                break;
+            case TSDB_DATA_TYPE_TINYINT:
+                ((int8_t *)field->data)[k] = (int8_t)(field->min
+                    + (taosRandom() % (field->max - field->min)));
+                break;
+            case TSDB_DATA_TYPE_UTINYINT:
+                ((uint8_t *)field->data)[k] = (uint8_t)(field->min
+                    + (taosRandom() % (field->max - field->min)));
+                break;
+            case TSDB_DATA_TYPE_SMALLINT:
+                ((int16_t *)field->data)[k] = (int16_t)(field->min
+                    + (taosRandom() % (field->max - field->min)));
+                break;
+            case TSDB_DATA_TYPE_USMALLINT:
+                ((uint16_t *)field->data)[k] = (uint16_t)(field->min
+                    + (taosRandom() % (field->max - field->min)));
+                break;
+            case TSDB_DATA_TYPE_INT:
+                if (g_arguments->demo_mode && colIndex == 0) {
+                    ((int32_t *)field->data)[k] = taosRandom() % 10 + 1;
+                } else if (g_arguments->demo_mode && colIndex == 1) {
+                    ((int32_t *)field->data)[k] = 105 + taosRandom() % 10;
+                } else {
+                    ((int32_t *)field->data)[k] = (int32_t)(field->min
+                        + (taosRandom() % (field->max - field->min)));
+                }
+                break;
+            case TSDB_DATA_TYPE_UINT:
+                ((uint32_t *)field->data)[k] = (uint32_t)(field->min
+                    + (taosRandom() % (field->max - field->min)));
+                break;
+            case TSDB_DATA_TYPE_BIGINT:
+                ((int64_t *)field->data)[k] = field->min
+                    + (taosRandom() % (field->max - field->min));
+                break;
+            case TSDB_DATA_TYPE_UBIGINT:
+            case TSDB_DATA_TYPE_TIMESTAMP:
+                ((uint64_t *)field->data)[k] = field->min
+                    + (taosRandom() % (field->max - field->min));
+                break;
+            case TSDB_DATA_TYPE_FLOAT: {
+                float _float = (float)(field->min +
+                                       (taosRandom() %
+                                        (field->max - field->min)) +
+                                       (taosRandom() % 1000) / 1000.0);
+                if (g_arguments->demo_mode && colIndex == 0) {
+                    _float = (float)(9.8 + 0.04 * (taosRandom() % 10) +
+                                     _float / 1000000000);
+                } else if (g_arguments->demo_mode && colIndex == 2) {
+                    _float = (float)((105 + taosRandom() % 10 +
+                                      _float / 1000000000) / 360);
+                }
+                ((float *)field->data)[k] = _float;
+                break;
+            }
+            case TSDB_DATA_TYPE_DOUBLE:
+                ((double *)field->data)[k] =
+                    (double)(field->min +
+                             (taosRandom() % (field->max - field->min)) +
+                             taosRandom() % 1000000 / 1000000.0);
+                break;
+            case TSDB_DATA_TYPE_BINARY:
+            case TSDB_DATA_TYPE_NCHAR:
+                if (g_arguments->demo_mode) {
+                    unsigned int tmpRand = taosRandom();
+                    snprintf(tmp, field->length + 1, "%s",
+                             g_arguments->chinese
+                                ? locations_chinese[tmpRand % 10]
+                                : locations[tmpRand % 10]);
+                } else if (field->values) {
+                    tools_cJSON *buf = tools_cJSON_GetArrayItem(
+                        field->values,
+                        taosRandom() % tools_cJSON_GetArraySize(field->values));
+                    snprintf(tmp, field->length, "%s", buf->valuestring);
+                } else {
+                    rand_string(tmp, field->length, g_arguments->chinese);
+                }
+                strncpy((char *)field->data + k * field->length, tmp,
+                        field->length);
+                break;
+            default:
+                break;
+        }
+    }
+    tmfree(tmp);
+}
+
+static void *fillStmtPoolRows(void *arg) {
+    SStmtPoolWorker *worker = (SStmtPoolWorker *)arg;
+    SBenchRand       rand;
+    // a stream of its own, apart from the insert threads' streams
+    benchRandSeed(&rand, g_arguments->random_seed,
+                  ((uint64_t)1 << 32) + worker->seq);
+    benchRandBind(&rand);
+    for (int c = 0; c < worker->stbInfo->cols->size; c++) {
+        Field *col = benchArrayGet(worker->stbInfo->cols, c);
+        fillStmtColumn(col, c, worker->from, worker->to);
+    }
+    benchRandBind(NULL);
+    return NULL;
+}
+
+// store one value, as written in a sample row or a tag list, in the
+// binary form stmt binds it with, returns the length stored
+static int32_t parseStmtValue(Field *field, char *dst, const char *text) {
+    switch (field->type) {
+        case TSDB_DATA_TYPE_INT:
+        case TSDB_DATA_TYPE_UINT:
+            *(int32_t *)dst = atoi(text);
+            return sizeof(int32_t);
+        case TSDB_DATA_TYPE_FLOAT:
+            *(float *)dst = (float)atof(text);
+            return sizeof(float);
+        case TSDB_DATA_TYPE_DOUBLE:
+            *(double *)dst = atof(text);
+            return sizeof(double);
+        case TSDB_DATA_TYPE_BOOL:
+            *(int8_t *)dst = (0 == strcasecmp(text, "true")) || atoi(text);
+            return sizeof(int8_t);
+        case TSDB_DATA_TYPE_TINYINT:
+        case TSDB_DATA_TYPE_UTINYINT:
+            *(int8_t *)dst = (int8_t)atoi(text);
+            return sizeof(int8_t);
+        case TSDB_DATA_TYPE_SMALLINT:
+        case TSDB_DATA_TYPE_USMALLINT:
+            *(int16_t *)dst = (int16_t)atoi(text);
+            return sizeof(int16_t);
+        case TSDB_DATA_TYPE_BIGINT:
+        case TSDB_DATA_TYPE_UBIGINT:
+        case TSDB_DATA_TYPE_TIMESTAMP:
+            *(int64_t *)dst = (int64_t)atol(text);
+            return sizeof(int64_t);
+        case TSDB_DATA_TYPE_BINARY:
+        case TSDB_DATA_TYPE_NCHAR: {
+            // strip the quotes around the value
+            size_t len = strlen(text);
+            if (len >= 2 && (text[0] == '\'' || text[0] == '"')) {
+                text++;
+                len -= 2;
+            }
+            if (len > field->length) {
+                errorPrint("data length %" PRIu64 " "
+                           "is larger than column length %d\n",
+                           (uint64_t)len, field->length);
+                len = field->length;
+            }
+            memcpy(dst, text, len);
+            return (int32_t)len;
+        }
+        default:
+            return 0;
+    }
+}
+
+// parse the textual csv sample once into the typed pool
+static int parseStmtPoolFromSample(SSuperTable *stbInfo) {
+    int32_t columnCount = stbInfo->cols->size;
+    char   *tmpStr = benchCalloc(1, stbInfo->lenOfCols + 1, false);
+
+    if (stbInfo->useSampleTs) {
+        columnCount += 1;  // for skipping first column
+    }
+    char   *rowStr = benchCalloc(1, stbInfo->lenOfCols + 1, false);
+    for (int64_t i = 0; i < g_arguments->prepared_rand; i++) {
+        // the typed pool keeps prepared_rand rows, wrapping short files
+        int32_t rowLen;
+        char   *row = benchCsvRow(stbInfo->sampleCsv,
+                                  i % stbInfo->sampleCsv->rows, &rowLen);
+        memcpy(rowStr, row, rowLen);
+        rowStr[rowLen] = '\0';
+        char *restStr = rowStr;
+
+        for (int c = 0; c < columnCount; c++) {
+            int index = 0;
+            while (restStr[index] && restStr[index] != ',') {
+                index++;
+            }
+            memcpy(tmpStr, restStr, index);
+            tmpStr[index] = '\0';
+            restStr += restStr[index] ? index + 1 : index;
+            if ((0 == c) && stbInfo->useSampleTs) {
+                continue;
+            }
+
+            Field *col = benchArrayGet(stbInfo->cols,
+                                       (stbInfo->useSampleTs ? c - 1 : c));
+            if (0 == strcmp(tmpStr, "NULL")) {
+                col->is_null[i] = true;
+                continue;
+            }
+            parseStmtValue(col, (char *)col->data + i * col->length, tmpStr);
+        }
+    }
+    tmfree(tmpStr);
+    tmfree(rowStr);
+    return 0;
+}
+
+// fill in the actual lengths of variable length values, then repeat the
+// head of the pool after its end
+static void mirrorStmtColumnPool(SSuperTable *stbInfo,
+                                 int64_t rows, int64_t total) {
+    for (int c = 0; c < stbInfo->cols->size; c++) {
+        Field *col = benchArrayGet(stbInfo->cols, c);
+        if (col->lengths) {
+            for (int64_t k = 0; k < rows; k++) {
+                const char *value = (char *)col->data + k * col->length;
+                int32_t     len = 0;
+                while (len < col->length && value[len]) {
+                    len++;
+                }
+                col->lengths[k] = len;
+            }
+        }
+        for (int64_t k = rows; k < total; k++) {
+            int64_t src = k % rows;
+            memcpy((char *)col->data + k * col->length,
+                   (char *)col->data + src * col->length, col->length);
+            col->is_null[k] = col->is_null[src];
+            if (col->lengths) {
+                col->lengths[k] = col->lengths[src];
+            }
+        }
+    }
+}
+
+// typed column arrays shared read-only by every stmt thread, built once
+// per super table instead of once per thread
+static int prepareStmtColumnPool(SSuperTable *stbInfo) {
+    int64_t rows = g_arguments->prepared_rand;
+    int64_t total = rows + g_arguments->reqPerReq;
+    stbInfo->stmtBatchMax = g_arguments->reqPerReq;
+    for (int c = 0; c < stbInfo->cols->size; c++) {
+        Field *col = benchArrayGet(stbInfo->cols, c);
+        switch (col->type) {
+            case TSDB_DATA_TYPE_BINARY:
+            case TSDB_DATA_TYPE_NCHAR:
+                col->data = benchCalloc(1, total * col->length + 1, true);
+                col->lengths = benchCalloc(total, sizeof(int32_t), true);
+                break;
+            case TSDB_DATA_TYPE_BOOL:
+            case TSDB_DATA_TYPE_TINYINT:
+            case TSDB_DATA_TYPE_UTINYINT:
+            case TSDB_DATA_TYPE_SMALLINT:
+            case TSDB_DATA_TYPE_USMALLINT:
+            case TSDB_DATA_TYPE_INT:
+            case TSDB_DATA_TYPE_UINT:
+            case TSDB_DATA_TYPE_BIGINT:
+            case TSDB_DATA_TYPE_UBIGINT:
+            case TSDB_DATA_TYPE_TIMESTAMP:
+            case TSDB_DATA_TYPE_FLOAT:
+            case TSDB_DATA_TYPE_DOUBLE:
+                col->data = benchCalloc(total, col->length, true);
+                break;
+            default:
+                errorPrint("Unknown data type: %s\n",
+                           convertDatatypeToString(col->type));
+                return -1;
+        }
+        col->is_null = benchCalloc(1, total, true);
+        if (col->type == TSDB_DATA_TYPE_INT) {
+            if (col->min < (-1 * (RAND_MAX >> 1))) {
+                col->min = -1 * (RAND_MAX >> 1);
+            }
+            if (col->max > (RAND_MAX >> 1)) {
+                col->max = RAND_MAX >> 1;
+            }
+        }
+        if (col->values && 0 == tools_cJSON_GetArraySize(col->values)) {
+            errorPrint("%s() cannot read correct value from json file "
+                       "for column %s\n", __func__, col->name);
+            return -1;
+        }
+    }
+
+    if (!stbInfo->random_data_source) {
+        if (parseStmtPoolFromSample(stbInfo)) {
+            return -1;
+        }
+        mirrorStmtColumnPool(stbInfo, rows, total);
+        return 0;
+    }
+
+    int32_t workers = g_arguments->nthreads;
+    if (workers > rows / 1024) {
+        workers = (int32_t)(rows / 1024);
+    }
+    if (workers < 1) {
+        workers = 1;
+    }
+    SStmtPoolWorker *pool = benchCalloc(workers, sizeof(SStmtPoolWorker),
+                                        true);
+    int64_t from = 0;
+    for (int32_t w = 0; w < workers; w++) {
+        pool[w].stbInfo = stbInfo;
+        pool[w].seq = w;
+        pool[w].from = from;
+        pool[w].to = from + rows / workers + (w < rows % workers ? 1 : 0);
+        from = pool[w].to;
+        pthread_create(&pool[w].pid, NULL, fillStmtPoolRows, pool + w);
+    }
+    for (int32_t w = 0; w < workers; w++) {
+        pthread_join(pool[w].pid, NULL);
+    }
+    tmfree(pool);
+    mirrorStmtColumnPool(stbInfo, rows, total);
     return 0;
 }
 
@@ -759,49 +1403,77 @@ int prepareSampleData(SDataBase* database, SSuperTable* stbInfo) {
     } else {
         stbInfo->partialColNum = stbInfo->cols->size;
     }
-    stbInfo->sampleDataBuf =
-            benchCalloc(1, stbInfo->lenOfCols * g_arguments->prepared_rand, true);
+    stbInfo->sampleRows = g_arguments->prepared_rand;
     infoPrint(
               "generate stable<%s> columns data with lenOfCols<%u> * "
               "prepared_rand<%" PRIu64 ">\n",
               stbInfo->stbName, stbInfo->lenOfCols, g_arguments->prepared_rand);
-    if (stbInfo->random_data_source) {
+    if (stbInfo->iface == STMT_IFACE && stbInfo->random_data_source) {
+        // stmt binds the typed pool only, no text rows are needed
+        if (prepareStmtColumnPool(stbInfo)) {
+            return -1;
+        }
+    } else if (stbInfo->random_data_source) {
+        stbInfo->sampleDataBuf = benchCalloc(
+            1, stbInfo->lenOfCols * g_arguments->prepared_rand, true);
         if (generateRandData(stbInfo, stbInfo->sampleDataBuf, stbInfo->lenOfCols,
                          stbInfo->cols, g_arguments->prepared_rand, false)) {
             return -1;
         }
     } else {
-        if (stbInfo->useSampleTs) {
-            if (getAndSetRowsFromCsvFile(stbInfo)) return -1;
-        }
-        if (generateSampleFromCsvForStb(stbInfo->sampleDataBuf,
-                                        stbInfo->sampleFile, stbInfo->lenOfCols,
-                                        g_arguments->prepared_rand)) {
+        stbInfo->sampleCsv = benchCsvOpen(stbInfo->sampleFile,
+                                          stbInfo->lenOfCols);
+        if (NULL == stbInfo->sampleCsv) {
             errorPrint("Failed to generate sample from csv file %s\n",
                     stbInfo->sampleFile);
             return -1;
         }
+        // the whole file is replayed, not only prepared_rand rows
+        stbInfo->sampleRows = stbInfo->sampleCsv->rows;
+        if (stbInfo->useSampleTs) {
+            stbInfo->insertRows = stbInfo->sampleCsv->rows;
+        }
+        if (stbInfo->iface == STMT_IFACE
+                && prepareStmtColumnPool(stbInfo)) {
+            return -1;
+        }
+    }
+    if (stbInfo->sampleDataBuf) {
+        debugPrint("sampleDataBuf: %s\n", stbInfo->sampleDataBuf);
     }
-    debugPrint("sampleDataBuf: %s\n", stbInfo->sampleDataBuf);
 
     if (!stbInfo->childTblExists && stbInfo->tags->size != 0) {
-        stbInfo->tagDataBuf =
-                benchCalloc(1, stbInfo->childTblCount * stbInfo->lenOfTags, true);
-        infoPrint(
-                  "generate stable<%s> tags data with lenOfTags<%u> * "
-                  "childTblCount<%" PRIu64 ">\n",
-                  stbInfo->stbName, stbInfo->lenOfTags, stbInfo->childTblCount);
+        int64_t maxRows = TAG_DATA_BUF_LIMIT / stbInfo->lenOfTags;
+        if (maxRows < 1) {
+            maxRows = 1;
+        }
         if (stbInfo->tagsFile[0] != 0) {
-            if (generateSampleFromCsvForStb(
-                    stbInfo->tagDataBuf, stbInfo->tagsFile, stbInfo->lenOfTags,
-                    stbInfo->childTblCount)) {
+            // rows of the tags file repeat over the child tables
+            stbInfo->tagsCsv = benchCsvOpen(stbInfo->tagsFile,
+                                            stbInfo->lenOfTags);
+            if (NULL == stbInfo->tagsCsv) {
                 return -1;
             }
+            stbInfo->tagDataRows = 0;
+        } else if ((int64_t)stbInfo->childTblCount <= maxRows) {
+            stbInfo->tagDataRows = stbInfo->childTblCount;
         } else {
-            if (generateRandData(stbInfo, stbInfo->tagDataBuf, stbInfo->lenOfTags,
-                             stbInfo->tags, stbInfo->childTblCount, true)) {
-                return -1;
-            }
+            stbInfo->tagDataRows = 0;
+            infoPrint("stable<%s> tags of %" PRIu64 " child tables are "
+                      "generated per table\n",
+                      stbInfo->stbName, stbInfo->childTblCount);
+        }
+    }
+    if (stbInfo->tagDataRows > 0) {
+        stbInfo->tagDataBuf =
+                benchCalloc(1, stbInfo->tagDataRows * stbInfo->lenOfTags, true);
+        infoPrint(
+                  "generate stable<%s> tags data with lenOfTags<%u> * "
+                  "rows<%" PRId64 ">\n",
+                  stbInfo->stbName, stbInfo->lenOfTags, stbInfo->tagDataRows);
+        if (generateRandData(stbInfo, stbInfo->tagDataBuf, stbInfo->lenOfTags,
+                             stbInfo->tags, stbInfo->tagDataRows, true)) {
+            return -1;
         }
         debugPrint("tagDataBuf: %s\n", stbInfo->tagDataBuf);
     }
@@ -825,44 +1497,162 @@ int64_t getTSRandTail(int64_t timeStampStep, int32_t seq, int disorderRatio,
     return randTail;
 }
 
-uint32_t bindParamBatch(threadInfo *pThreadInfo, uint32_t batch, int64_t startTime) {
-    TAOS_STMT *  stmt = pThreadInfo->conn->stmt;
+// set up the parts of the bind that stay the same across batches
+void prepareStmtBind(threadInfo *pThreadInfo) {
     SSuperTable *stbInfo = pThreadInfo->stbInfo;
     uint32_t     columnCount = stbInfo->cols->size;
-    memset(pThreadInfo->bindParams, 0,
-           (sizeof(TAOS_MULTI_BIND) * (columnCount + 1)));
-    memset(pThreadInfo->is_null, 0, batch);
-
-    for (int c = 0; c < columnCount + 1; c++) {
-        TAOS_MULTI_BIND *param =
-            (TAOS_MULTI_BIND *)(pThreadInfo->bindParams +
-                                sizeof(TAOS_MULTI_BIND) * c);
+    uint32_t     reqPerReq = g_arguments->reqPerReq;
 
-        char data_type;
+    pThreadInfo->bind_ts_array =
+        benchCalloc(reqPerReq, sizeof(int64_t), true);
+    pThreadInfo->bindParams =
+        benchCalloc(columnCount + 1, sizeof(TAOS_MULTI_BIND), true);
+    pThreadInfo->bind_lengths =
+        benchCalloc((uint64_t)(columnCount + 1) * reqPerReq,
+                    sizeof(int32_t), true);
 
+    TAOS_MULTI_BIND *params = (TAOS_MULTI_BIND *)pThreadInfo->bindParams;
+    for (int c = 0; c < columnCount + 1; c++) {
+        TAOS_MULTI_BIND *param = params + c;
         if (c == 0) {
-            data_type = TSDB_DATA_TYPE_TIMESTAMP;
+            param->buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
             param->buffer_length = sizeof(int64_t);
             param->buffer = pThreadInfo->bind_ts_array;
-
         } else {
-            Field * col = benchArrayGet(stbInfo->cols, c - 1);
-            data_type = col->type;
-            param->buffer = col->data;
+            Field *col = benchArrayGet(stbInfo->cols, c - 1);
+            param->buffer_type = col->type;
             param->buffer_length = col->length;
-            debugPrint("col[%d]: type: %s, len: %d\n", c,
-                       convertDatatypeToString(data_type),
-                       col->length);
-            param->is_null = col->is_null;
         }
-        param->buffer_type = data_type;
-        param->length = benchCalloc(batch, sizeof(int32_t), true);
-
-        for (int b = 0; b < batch; b++) {
+        param->length = pThreadInfo->bind_lengths + (uint64_t)c * reqPerReq;
+        for (int b = 0; b < reqPerReq; b++) {
             param->length[b] = (int32_t)param->buffer_length;
         }
+    }
+
+    if (!stbInfo->stmtTagBind) {
+        return;
+    }
+    uint32_t tagCount = stbInfo->tags->size;
+    uint64_t size = 0;
+    for (int t = 0; t < tagCount; t++) {
+        Field *tag = benchArrayGet(stbInfo->tags, t);
+        size += tag->length;
+    }
+    pThreadInfo->tagBindParams =
+        benchCalloc(tagCount, sizeof(TAOS_MULTI_BIND), true);
+    pThreadInfo->tagBindBuf = benchCalloc(1, size, true);
+    pThreadInfo->tagBindText = benchCalloc(1, stbInfo->lenOfTags + 1, true);
+    pThreadInfo->tagBindLengths = benchCalloc(tagCount, sizeof(int32_t), true);
+    pThreadInfo->tagBindNull = benchCalloc(tagCount, 1, true);
+    TAOS_MULTI_BIND *tags = (TAOS_MULTI_BIND *)pThreadInfo->tagBindParams;
+    uint64_t offset = 0;
+    for (int t = 0; t < tagCount; t++) {
+        Field *tag = benchArrayGet(stbInfo->tags, t);
+        tags[t].buffer_type = tag->type;
+        tags[t].buffer_length = tag->length;
+        tags[t].buffer = pThreadInfo->tagBindBuf + offset;
+        tags[t].length = pThreadInfo->tagBindLengths + t;
+        tags[t].is_null = pThreadInfo->tagBindNull + t;
+        tags[t].num = 1;
+        offset += tag->length;
+    }
+}
+
+// only tags parseStmtValue() can store are bound, tables with a json or
+// another tag type keep a statement per table
+bool stmtTagsBindable(SSuperTable *stbInfo) {
+    for (int t = 0; t < stbInfo->tags->size; t++) {
+        Field *tag = benchArrayGet(stbInfo->tags, t);
+        switch (tag->type) {
+            case TSDB_DATA_TYPE_INT:
+            case TSDB_DATA_TYPE_UINT:
+            case TSDB_DATA_TYPE_FLOAT:
+            case TSDB_DATA_TYPE_DOUBLE:
+            case TSDB_DATA_TYPE_BOOL:
+            case TSDB_DATA_TYPE_TINYINT:
+            case TSDB_DATA_TYPE_UTINYINT:
+            case TSDB_DATA_TYPE_SMALLINT:
+            case TSDB_DATA_TYPE_USMALLINT:
+            case TSDB_DATA_TYPE_BIGINT:
+            case TSDB_DATA_TYPE_UBIGINT:
+            case TSDB_DATA_TYPE_TIMESTAMP:
+            case TSDB_DATA_TYPE_BINARY:
+            case TSDB_DATA_TYPE_NCHAR:
+                break;
+            default:
+                return false;
+        }
+    }
+    return stbInfo->tags->size > 0;
+}
+
+// point the long-lived auto-create statement at the next table: its
+// name and its tags, parsed from the same text the SQL path inserts
+int setStmtTbnameTags(threadInfo *pThreadInfo, uint64_t tableSeq,
+                      char *tableName) {
+    SSuperTable *    stbInfo = pThreadInfo->stbInfo;
+    TAOS_STMT *      stmt = pThreadInfo->conn->stmt;
+    TAOS_MULTI_BIND *tags = (TAOS_MULTI_BIND *)pThreadInfo->tagBindParams;
+    char *           text = pThreadInfo->tagBindText;
+    snprintf(text, stbInfo->lenOfTags + 1, "%s",
+             getTagData(stbInfo, tableSeq));
+
+    for (int t = 0; t < stbInfo->tags->size; t++) {
+        Field *tag = benchArrayGet(stbInfo->tags, t);
+        char * value = text;
+        char   quote = 0;
+        // a comma inside a quoted string value does not end it
+        while (*text && (quote || *text != ',')) {
+            if (*text == quote) {
+                quote = 0;
+            } else if (!quote && (*text == '\'' || *text == '"')) {
+                quote = *text;
+            }
+            text++;
+        }
+        if (*text) {
+            *text++ = '\0';
+        }
+        if (0 == strcmp(value, "NULL")) {
+            tags[t].is_null[0] = true;
+            continue;
+        }
+        tags[t].is_null[0] = false;
+        tags[t].length[0] = parseStmtValue(tag, tags[t].buffer, value);
+    }
+    if (taos_stmt_set_tbname_tags(stmt, tableName, tags)) {
+        errorPrint("taos_stmt_set_tbname_tags(%s) failed, reason: %s\n",
+                   tableName, taos_stmt_errstr(stmt));
+        return -1;
+    }
+    return 0;
+}
+
+uint32_t bindParamBatch(threadInfo *pThreadInfo, uint32_t batch, int64_t startTime) {
+    TAOS_STMT *  stmt = pThreadInfo->conn->stmt;
+    SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    uint32_t     columnCount = stbInfo->cols->size;
+    uint64_t     pos = pThreadInfo->samplePos;
+    TAOS_MULTI_BIND *params = (TAOS_MULTI_BIND *)pThreadInfo->bindParams;
+
+    if (batch > stbInfo->stmtBatchMax) {
+        batch = stbInfo->stmtBatchMax;
+    }
+
+    // bind a window of the shared pool starting at this thread's cursor,
+    // the mirrored tail keeps the window contiguous
+    params[0].num = batch;
+    for (int c = 1; c < columnCount + 1; c++) {
+        TAOS_MULTI_BIND *param = params + c;
+        Field *          col = benchArrayGet(stbInfo->cols, c - 1);
+        param->buffer = (char *)col->data + pos * col->length;
+        param->is_null = col->is_null + pos;
+        if (col->lengths) {
+            param->length = col->lengths + pos;
+        }
         param->num = batch;
     }
+    pThreadInfo->samplePos = (pos + batch) % g_arguments->prepared_rand;
 
     for (uint32_t k = 0; k < batch; k++) {
         /* columnCount + 1 (ts) */
@@ -877,20 +1667,12 @@ uint32_t bindParamBatch(threadInfo *pThreadInfo, uint32_t batch, int64_t startTi
         }
     }
 
-    if (taos_stmt_bind_param_batch(
-            stmt, (TAOS_MULTI_BIND *)pThreadInfo->bindParams)) {
+    if (taos_stmt_bind_param_batch(stmt, params)) {
         errorPrint("taos_stmt_bind_param_batch() failed! reason: %s\n",
                    taos_stmt_errstr(stmt));
         return 0;
     }
 
-    for (int c = 0; c < stbInfo->cols->size + 1; c++) {
-        TAOS_MULTI_BIND *param =
-            (TAOS_MULTI_BIND *)(pThreadInfo->bindParams +
-                                sizeof(TAOS_MULTI_BIND) * c);
-        tmfree(param->length);
-    }
-
     // if msg > 3MB, break
     if (taos_stmt_add_batch(stmt)) {
         errorPrint("taos_stmt_add_batch() failed! reason: %s\n",
@@ -900,8 +1682,10 @@ uint32_t bindParamBatch(threadInfo *pThreadInfo, uint32_t batch, int64_t startTi
     return batch;
 }
 
-void generateSmlJsonTags(tools_cJSON *tagsList, SSuperTable *stbInfo,
-                            uint64_t start_table_from, int tbSeq) {
+// Serialise the tag object of one child table once, the writers splice the
+// returned fragment into every record of that table.
+char *generateSmlJsonTags(SSuperTable *stbInfo,
+                          uint64_t start_table_from, int tbSeq) {
     tools_cJSON * tags = tools_cJSON_CreateObject();
     char *  tbName = benchCalloc(1, TSDB_TABLE_NAME_LEN, true);
     snprintf(tbName, TSDB_TABLE_NAME_LEN, "%s%" PRIu64 "",
@@ -959,72 +1743,83 @@ void generateSmlJsonTags(tools_cJSON *tagsList, SSuperTable *stbInfo,
         }
         tools_cJSON_AddItemToObject(tags, tagName, tagObj);
     }
-    tools_cJSON_AddItemToArray(tagsList, tags);
+    char *fragment = tools_cJSON_PrintUnformatted(tags);
+    tools_cJSON_Delete(tags);
     tmfree(tagName);
     tmfree(tbName);
+    return fragment;
 }
 
-void generateSmlJsonCols(tools_cJSON *array, tools_cJSON *tag,
-                         SSuperTable *stbInfo,
-                            uint32_t time_precision, int64_t timestamp) {
-    tools_cJSON * record = tools_cJSON_CreateObject();
-    tools_cJSON * ts = tools_cJSON_CreateObject();
-    tools_cJSON_AddNumberToObject(ts, "value", (double)timestamp);
+// Upper bound of the fragment generateSmlJsonTags() writes: the id and,
+// per tag, its key, type and a value of at most max(number, length).
+uint64_t smlJsonTagsLen(SSuperTable *stbInfo) {
+    uint64_t len = 16 + TSDB_TABLE_NAME_LEN;
+    for (int i = 0; i < stbInfo->tags->size; i++) {
+        Field *tag = benchArrayGet(stbInfo->tags, i);
+        len += 64 + tag->length;
+    }
+    return len;
+}
+
+// Upper bound of one record written by generateSmlJsonCols() besides the
+// tag fragment.
+uint64_t smlJsonColsLen(SSuperTable *stbInfo) {
+    Field *col = benchArrayGet(stbInfo->cols, 0);
+    return 160 + strlen(stbInfo->stbName) + col->length;
+}
+
+// Write one OpenTSDB JSON record straight into buf and return its length.
+int generateSmlJsonCols(char *buf, const char *tag, SSuperTable *stbInfo,
+                        uint32_t time_precision, int64_t timestamp) {
+    int len = 0;
+    len += sprintf(buf + len, "{\"timestamp\":{\"value\":%" PRId64 "",
+                   timestamp);
     if (time_precision == TSDB_SML_TIMESTAMP_MILLI_SECONDS) {
-        tools_cJSON_AddStringToObject(ts, "type", "ms");
+        len += sprintf(buf + len, ",\"type\":\"ms\"");
     } else if (time_precision == TSDB_SML_TIMESTAMP_MICRO_SECONDS) {
-        tools_cJSON_AddStringToObject(ts, "type", "us");
+        len += sprintf(buf + len, ",\"type\":\"us\"");
     } else if (time_precision == TSDB_SML_TIMESTAMP_NANO_SECONDS) {
-        tools_cJSON_AddStringToObject(ts, "type", "ns");
+        len += sprintf(buf + len, ",\"type\":\"ns\"");
     }
-    tools_cJSON *value = tools_cJSON_CreateObject();
+    len += sprintf(buf + len, "},\"value\":{\"value\":");
     Field* col = benchArrayGet(stbInfo->cols, 0);
     switch (col->type) {
         case TSDB_DATA_TYPE_BOOL:
-            tools_cJSON_AddBoolToObject(value, "value", (taosRandom()%2)&1);
-            tools_cJSON_AddStringToObject(value, "type", "bool");
+            len += sprintf(buf + len, "%s,\"type\":\"bool\"",
+                           ((taosRandom()%2)&1) ? "true" : "false");
             break;
         case TSDB_DATA_TYPE_FLOAT:
-            tools_cJSON_AddNumberToObject(
-                value, "value",
-                (float)(col->min +
-                        (taosRandom() % (col->max - col->min)) +
-                        taosRandom() % 1000 / 1000.0));
-            tools_cJSON_AddStringToObject(value, "type", "float");
+            len += sprintf(buf + len, "%.15g,\"type\":\"float\"",
+                           (float)(col->min +
+                                   (taosRandom() % (col->max - col->min)) +
+                                   taosRandom() % 1000 / 1000.0));
             break;
         case TSDB_DATA_TYPE_DOUBLE:
-            tools_cJSON_AddNumberToObject(
-                value, "value",
-                (double)(col->min +
-                         (taosRandom() % (col->max - col->min)) +
-                         taosRandom() % 1000000 / 1000000.0));
-            tools_cJSON_AddStringToObject(value, "type", "double");
+            len += sprintf(buf + len, "%.15g,\"type\":\"double\"",
+                           (double)(col->min +
+                                    (taosRandom() % (col->max - col->min)) +
+                                    taosRandom() % 1000000 / 1000000.0));
             break;
         case TSDB_DATA_TYPE_BINARY:
         case TSDB_DATA_TYPE_NCHAR: {
-            char *buf = (char *)benchCalloc(col->length + 1, 1, false);
-            rand_string(buf, col->length, g_arguments->chinese);
-            if (col->type == TSDB_DATA_TYPE_BINARY) {
-                tools_cJSON_AddStringToObject(value, "value", buf);
-                tools_cJSON_AddStringToObject(value, "type", "binary");
-            } else {
-                tools_cJSON_AddStringToObject(value, "value", buf);
-                tools_cJSON_AddStringToObject(value, "type", "nchar");
-            }
-            tmfree(buf);
+            // random strings are alphanumeric or CJK, nothing to escape
+            buf[len++] = '"';
+            memset(buf + len, 0, col->length + 1);
+            rand_string(buf + len, col->length, g_arguments->chinese);
+            len += (int)strlen(buf + len);
+            len += sprintf(buf + len, "\",\"type\":\"%s\"",
+                           col->type == TSDB_DATA_TYPE_BINARY
+                               ? "binary" : "nchar");
             break;
         }
         default:
-            tools_cJSON_AddNumberToObject(
-                    value, "value",
-                    (double)col->min +
-                    (taosRandom() % (col->max - col->min)));
-            tools_cJSON_AddStringToObject(value, "type", convertDatatypeToString(col->type));
+            len += sprintf(buf + len, "%" PRId64 ",\"type\":\"%s\"",
+                           col->min + (int64_t)(taosRandom() %
+                                                (col->max - col->min)),
+                           convertDatatypeToString(col->type));
             break;
     }
-    tools_cJSON_AddItemToObject(record, "timestamp", ts);
-    tools_cJSON_AddItemToObject(record, "value", value);
-    tools_cJSON_AddItemToObject(record, "tags", tag);
-    tools_cJSON_AddStringToObject(record, "metric", stbInfo->stbName);
-    tools_cJSON_AddItemToArray(array, record);
+    len += sprintf(buf + len, "},\"tags\":%s,\"metric\":\"%s\"}",
+                   tag, stbInfo->stbName);
+    return len;
 }
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the MIT license as published by the Free Software
+ * Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "bench.h"
+#ifndef WINDOWS
+#include <sys/uio.h>
+#endif
+#ifdef DEFLATE_CODEC
+#include <zlib.h>
+#endif
+
+// one response buffer per thread, reused by every request of that thread
+static BENCH_THREAD_LOCAL SBenchHttpResp g_httpResp;
+// compressed request bodies are staged here, also one per thread
+static BENCH_THREAD_LOCAL char *   g_httpZBuf;
+static BENCH_THREAD_LOCAL uint64_t g_httpZCap;
+static BENCH_THREAD_LOCAL uint64_t g_httpLastWire;
+#ifdef DEFLATE_CODEC
+static BENCH_THREAD_LOCAL z_stream g_httpZ;
+static BENCH_THREAD_LOCAL bool     g_httpZInited;
+#endif
+
+static int64_t httpFind(const char *buf, int64_t from, int64_t to,
+                        const char *pattern) {
+    int64_t n = (int64_t)strlen(pattern);
+    for (int64_t i = from; i + n <= to; i++) {
+        if (buf[i] == pattern[0] && 0 == memcmp(buf + i, pattern, n)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool httpHeaderIs(const char *line, int64_t len, const char *name) {
+    int64_t n = (int64_t)strlen(name);
+    return len > n && 0 == strncasecmp(line, name, n);
+}
+
+static int32_t httpSendAll(int sockfd, const char *head, int64_t headLen,
+                           const char *body, int64_t bodyLen) {
+#ifdef WINDOWS
+    const char *parts[2] = {head, body};
+    int64_t     lens[2] = {headLen, bodyLen};
+    for (int p = 0; p < 2; p++) {
+        int64_t sent = 0;
+        while (sent < lens[p]) {
+            int bytes = send(sockfd, parts[p] + sent,
+                             (int)(lens[p] - sent), 0);
+            if (bytes <= 0) {
+                errorPrint("%s", "writing no message to socket\n");
+                return -1;
+            }
+            sent += bytes;
+        }
+    }
+#else
+    struct iovec iov[2];
+    int          iovcnt = 0;
+    if (headLen > 0) {
+        iov[iovcnt].iov_base = (void *)head;
+        iov[iovcnt].iov_len = headLen;
+        iovcnt++;
+    }
+    if (bodyLen > 0) {
+        iov[iovcnt].iov_base = (void *)body;
+        iov[iovcnt].iov_len = bodyLen;
+        iovcnt++;
+    }
+    struct iovec *cur = iov;
+    while (iovcnt > 0) {
+        ssize_t bytes = writev(sockfd, cur, iovcnt);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            errorPrint("%s", "writing no message to socket\n");
+            return -1;
+        }
+        while (iovcnt > 0 && (size_t)bytes >= cur->iov_len) {
+            bytes -= cur->iov_len;
+            cur++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            cur->iov_base = (char *)cur->iov_base + bytes;
+            cur->iov_len -= bytes;
+        }
+    }
+#endif
+    return 0;
+}
+
+int32_t benchHttpSend(int sockfd, const char *data, uint64_t len) {
+    g_httpLastWire = len;
+    return httpSendAll(sockfd, NULL, 0, data, (int64_t)len);
+}
+
+const char *benchHttpEncoding() {
+    switch (g_arguments->rest_codec) {
+        case REST_CODEC_GZIP:
+            return "gzip";
+        case REST_CODEC_DEFLATE:
+            return "deflate";
+        default:
+            return NULL;
+    }
+}
+
+// Compress body with the configured codec into *out, growing it when the
+// worst case does not fit. The deflate state is kept per thread and only
+// reset between requests. Returns the compressed length or -1.
+int64_t benchHttpCompress(const char *body, uint64_t len,
+                          char **out, uint64_t *cap) {
+#ifdef DEFLATE_CODEC
+    z_stream *z = &g_httpZ;
+    if (!g_httpZInited) {
+        int windowBits = g_arguments->rest_codec == REST_CODEC_GZIP
+            ? MAX_WBITS + 16 : MAX_WBITS;
+        if (Z_OK != deflateInit2(z, g_arguments->rest_codec_level,
+                                 Z_DEFLATED, windowBits, 8,
+                                 Z_DEFAULT_STRATEGY)) {
+            errorPrint("%s", "failed to initialize request compression\n");
+            return -1;
+        }
+        g_httpZInited = true;
+    } else {
+        deflateReset(z);
+    }
+    uint64_t bound = deflateBound(z, (uLong)len);
+    if (*cap < bound) {
+        tmfree(*out);
+        *out = benchCalloc(1, bound, false);
+        *cap = bound;
+    }
+    z->next_in = (Bytef *)body;
+    z->avail_in = (uInt)len;
+    z->next_out = (Bytef *)*out;
+    z->avail_out = (uInt)bound;
+    if (Z_STREAM_END != deflate(z, Z_FINISH)) {
+        errorPrint("%s", "failed to compress request body\n");
+        return -1;
+    }
+    return (int64_t)z->total_out;
+#else
+    errorPrint("%s", "request compression needs zlib\n");
+    return -1;
+#endif
+}
+
+uint64_t benchHttpLastWireLen() {
+    return g_httpLastWire;
+}
+
+// Parse the status line and the framing headers once the header block is
+// complete. Returns the offset of the body or -1 while still incomplete.
+static int64_t httpParseHead(SBenchHttpResp *resp) {
+    int64_t from = resp->scanned > 3 ? resp->scanned - 3 : 0;
+    int64_t end = httpFind(resp->buf, from, resp->len, "\r\n\r\n");
+    resp->scanned = resp->len;
+    if (end < 0) {
+        return -1;
+    }
+    if (resp->len < 12 || 0 != strncmp(resp->buf, "HTTP/1.", 7)) {
+        resp->status = -1;
+        return end + 4;
+    }
+    resp->status = atoi(resp->buf + 9);
+
+    int64_t line = httpFind(resp->buf, 0, end + 2, "\r\n") + 2;
+    while (line < end + 2) {
+        int64_t eol = httpFind(resp->buf, line, end + 2, "\r\n");
+        const char *p = resp->buf + line;
+        int64_t     n = eol - line;
+        if (httpHeaderIs(p, n, "Content-Length:")) {
+            resp->contentLength = strtoll(p + 15, NULL, 10);
+        } else if (httpHeaderIs(p, n, "Transfer-Encoding:")) {
+            for (int64_t i = 18; i + 7 <= n; i++) {
+                if (0 == strncasecmp(p + i, "chunked", 7)) {
+                    resp->chunked = true;
+                    break;
+                }
+            }
+        }
+        line = eol + 2;
+    }
+    return end + 4;
+}
+
+// Decode whatever complete chunks have arrived, compacting the payload
+// right behind the header. Returns 1 once the terminating chunk is seen.
+static int32_t httpParseChunks(SBenchHttpResp *resp) {
+    while (true) {
+        int64_t eol = httpFind(resp->buf, resp->cursor, resp->len, "\r\n");
+        if (eol < 0) {
+            return 0;
+        }
+        int64_t size = strtoll(resp->buf + resp->cursor, NULL, 16);
+        if (size == 0) {
+            if (eol + 4 > resp->len) {
+                return 0;
+            }
+            resp->end = eol + 4;
+            return 1;
+        }
+        if (eol + 2 + size + 2 > resp->len) {
+            return 0;
+        }
+        memmove(resp->buf + resp->bodyStart + resp->bodyLen,
+                resp->buf + eol + 2, size);
+        resp->bodyLen += size;
+        resp->cursor = eol + 2 + size + 2;
+    }
+}
+
+// Drop the response that was handed out and keep any bytes of the next
+// one already received, so the parser also serves pipelined connections.
+void benchHttpNext(SBenchHttpResp *resp) {
+    if (resp->end > 0) {
+        resp->buf[resp->bodyStart + resp->bodyLen] = resp->saved;
+        memmove(resp->buf, resp->buf + resp->end, resp->len - resp->end);
+        resp->len -= resp->end;
+    } else {
+        resp->len = 0;
+    }
+    resp->scanned = 0;
+    resp->cursor = 0;
+    resp->end = 0;
+    resp->bodyStart = -1;
+    resp->bodyLen = 0;
+    resp->status = 0;
+    resp->contentLength = -1;
+    resp->chunked = false;
+    resp->body = NULL;
+}
+
+// Make room for at least one more read. Fails once limit is reached.
+int32_t benchHttpReserve(SBenchHttpResp *resp, uint64_t limit) {
+    if (resp->len < resp->cap) {
+        return 0;
+    }
+    if ((uint64_t)resp->cap >= limit) {
+        errorPrint("response exceeds %" PRIu64 " bytes\n", limit);
+        return -1;
+    }
+    uint64_t cap = resp->cap ? (uint64_t)resp->cap * 2 : RESP_BUF_LEN;
+    if (cap > limit) {
+        cap = limit;
+    }
+    char *buf = realloc(resp->buf, cap + 1);
+    if (NULL == buf) {
+        errorPrint("%s", "failed to allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    resp->buf = buf;
+    resp->cap = cap;
+    return 0;
+}
+
+// Feed the bytes received so far to the parser. Returns 1 when a whole
+// response is available, its body NUL terminated in place.
+int32_t benchHttpParse(SBenchHttpResp *resp) {
+    bool done = false;
+    if (resp->bodyStart < 0) {
+        resp->bodyStart = httpParseHead(resp);
+        if (resp->bodyStart < 0) {
+            return 0;
+        }
+        resp->cursor = resp->bodyStart;
+    }
+    if (resp->chunked) {
+        done = httpParseChunks(resp);
+    } else if (resp->contentLength >= 0) {
+        if (resp->len - resp->bodyStart >= resp->contentLength) {
+            resp->bodyLen = resp->contentLength;
+            resp->end = resp->bodyStart + resp->contentLength;
+            done = true;
+        }
+    } else if (resp->status == 204 || resp->status == 304
+               || (resp->status >= 100 && resp->status < 200)) {
+        resp->end = resp->bodyStart;
+        done = true;
+    }
+    if (!done) {
+        return 0;
+    }
+    resp->body = resp->buf + resp->bodyStart;
+    resp->saved = resp->body[resp->bodyLen];
+    resp->body[resp->bodyLen] = '\0';
+    debugPrint("response status: %d, body: %s\n", resp->status, resp->body);
+    return 1;
+}
+
+SBenchHttpResp *benchHttpRecv(int sockfd, uint64_t limit) {
+    SBenchHttpResp *resp = &g_httpResp;
+
+    resp->end = 0;
+    benchHttpNext(resp);
+    while (true) {
+        if (benchHttpReserve(resp, limit)) {
+            return NULL;
+        }
+        int bytes = recv(sockfd, resp->buf + resp->len,
+                         (int)(resp->cap - resp->len), 0);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            // a response without framing ends with the connection
+            if (bytes == 0 && resp->bodyStart >= 0
+                    && !resp->chunked && resp->contentLength < 0) {
+                resp->bodyLen = resp->len - resp->bodyStart;
+                resp->body = resp->buf + resp->bodyStart;
+                resp->body[resp->bodyLen] = '\0';
+                return resp;
+            }
+            errorPrint("%s", "reading no response from socket\n");
+            return NULL;
+        }
+        resp->len += bytes;
+        if (benchHttpParse(resp)) {
+            return resp;
+        }
+    }
+}
+
+int benchHttpHeader(char *head, int size, const char *url, uint16_t port,
+                    uint64_t bodyLen, const char *encoding) {
+    int headLen = snprintf(
+        head, size,
+        "POST %s HTTP/1.1\r\nHost: %s:%d\r\nAccept: */*\r\n"
+        "Authorization: Basic %s\r\nContent-Length: %" PRIu64 "\r\n"
+        "%s%s%s"
+        "Content-Type: application/x-www-form-urlencoded\r\n\r\n",
+        url, g_arguments->host, port, g_arguments->base64_buf, bodyLen,
+        encoding ? "Content-Encoding: " : "", encoding ? encoding : "",
+        encoding ? "\r\n" : "");
+    if (headLen >= size) {
+        ERROR_EXIT("too long request");
+    }
+    debugPrint("request header: %s\n", head);
+    return headLen;
+}
+
+SBenchHttpResp *benchHttpPost(int sockfd, const char *url, uint16_t port,
+                              const char *body, uint64_t bodyLen,
+                              uint64_t limit) {
+    const char *encoding = benchHttpEncoding();
+    if (encoding) {
+        int64_t zlen = benchHttpCompress(body, bodyLen,
+                                         &g_httpZBuf, &g_httpZCap);
+        if (zlen < 0) {
+            return NULL;
+        }
+        body = g_httpZBuf;
+        bodyLen = (uint64_t)zlen;
+    }
+    g_httpLastWire = bodyLen;
+
+    char head[BENCH_HTTP_HEADER_LEN];
+    int  headLen = benchHttpHeader(head, sizeof(head), url, port, bodyLen,
+                                   encoding);
+    if (httpSendAll(sockfd, head, headLen, body, (int64_t)bodyLen)) {
+        return NULL;
+    }
+    return benchHttpRecv(sockfd, limit);
+}
+
+void benchHttpFree(SBenchHttpResp *resp) {
+    tmfree(resp->buf);
+    memset(resp, 0, sizeof(SBenchHttpResp));
+}
+
+void benchHttpRelease() {
+    benchHttpFree(&g_httpResp);
+    tmfree(g_httpZBuf);
+    g_httpZBuf = NULL;
+    g_httpZCap = 0;
+#ifdef DEFLATE_CODEC
+    if (g_httpZInited) {
+        deflateEnd(&g_httpZ);
+        g_httpZInited = false;
+    }
+#endif
+}
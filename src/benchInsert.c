@@ -13,6 +13,11 @@
 #include "bench.h"
 #include "benchData.h"
 
+#ifdef LINUX
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
 static int getSuperTableFromServerRest(
     SDataBase* database, SSuperTable* stbInfo, char *command) {
 
@@ -25,6 +30,7 @@ static int getSuperTableFromServerRest(
     }
 
     int code = postProceSql(command,
+                         strlen(command),
                          database->dbName,
                          database->precision,
                          REST_IFACE,
@@ -300,15 +306,11 @@ int32_t getVgroupsOfDb(SBenchConn *conn, SDataBase *database) {
     int     vgroups = 0;
     char    cmd[SQL_BUFF_LEN] = "\0";
 
-    sprintf(cmd, "USE %s", database->dbName);
-
     int32_t   code;
     TAOS_RES *res = NULL;
 
-    res = taos_query(conn->taos, cmd);
-    code = taos_errno(res);
-    if (code) {
-        printErrCmdCodeStr(cmd, code, res);
+    if (benchSelectDb(conn, database->dbName)) {
+        errorPrint("failed to select database(%s)\n", database->dbName);
         return -1;
     }
 
@@ -414,6 +416,7 @@ int createDatabaseRest(SDataBase* database) {
 
     sprintf(command, "DROP DATABASE IF EXISTS %s;", database->dbName);
     code = postProceSql(command,
+                        strlen(command),
                         database->dbName,
                         database->precision,
                         REST_IFACE,
@@ -428,6 +431,7 @@ int createDatabaseRest(SDataBase* database) {
         int remainVnodes = INT_MAX;
         geneDbCreateCmd(database, command, remainVnodes);
         code = postProceSql(command,
+                            strlen(command),
                             database->dbName,
                             database->precision,
                             REST_IFACE,
@@ -484,6 +488,8 @@ int createDatabaseTaosc(SDataBase* database) {
     }
 
     sprintf(command, "DROP DATABASE IF EXISTS %s;", database->dbName);
+    // the cached USE state may point at the database just dropped
+    conn->db[0] = '\0';
     if (0 != queryDbExec(conn, command)) {
         close_bench_conn(conn);
         return -1;
@@ -560,6 +566,126 @@ int createDatabase(SDataBase* database) {
     return ret;
 }
 
+// child table creation keeps up to create_table_depth statements in
+// flight per connection. with batch_create_tbl_num "auto" the number of
+// tables per statement follows the observed latency, bounded by what
+// fits in one statement
+#define CREATE_BATCH_TARGET_US  (200 * 1000)
+
+typedef struct SCreateTuner_S {
+    bool    adaptive;
+    int64_t batch;       // tables per statement
+    double  usPerTable;  // moving average of latency per table
+} SCreateTuner;
+
+static void pipelinedCallback(void *param, TAOS_RES *res, int code);
+
+static void tuneCreateBatch(SCreateTuner *tuner, int64_t tables,
+                            int64_t latencyUs, int64_t sqlLen) {
+    if (!tuner->adaptive || tables <= 0 || latencyUs <= 0) {
+        return;
+    }
+    double perTable = (double)latencyUs / tables;
+    tuner->usPerTable = tuner->usPerTable > 0
+        ? 0.7 * tuner->usPerTable + 0.3 * perTable : perTable;
+    int64_t next = (int64_t)(CREATE_BATCH_TARGET_US / tuner->usPerTable);
+    // move at most by a factor of two per statement
+    next = min(max(next, tuner->batch / 2), tuner->batch * 2);
+    int64_t fit = (TSDB_MAX_SQL_LEN - EXTRA_SQL_LEN) / (sqlLen / tables + 1);
+    tuner->batch = max(min(next, fit), 1);
+}
+
+static int32_t execCreateSql(threadInfo *pThreadInfo, char *sql,
+                             int32_t trying) {
+    SDataBase *  database = pThreadInfo->dbInfo;
+    SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    if (REST_IFACE == stbInfo->iface) {
+        return queryDbExecRest(sql,
+                               database->dbName,
+                               database->precision,
+                               stbInfo->iface,
+                               stbInfo->lineProtocol,
+                               stbInfo->tcpTransfer,
+                               pThreadInfo->sockfd);
+    }
+    int32_t ret = queryDbExec(pThreadInfo->conn, sql);
+    while (ret && trying) {
+        infoPrint("will sleep %"PRIu32" milliseconds then re-create "
+                  "table %s\n",
+                  g_arguments->trying_interval, sql);
+        toolsMsleep(g_arguments->trying_interval);
+        ret = queryDbExec(pThreadInfo->conn, sql);
+        if (trying != -1) {
+            trying --;
+        }
+    }
+    return ret;
+}
+
+static void accountCreateSql(threadInfo *pThreadInfo, SCreateTuner *tuner,
+                             SBenchPipe *pipe) {
+    pThreadInfo->tables_created += pipe->rows;
+    atomic_add_fetch_64(&pThreadInfo->statRows, pipe->rows);
+    tuneCreateBatch(tuner, pipe->rows, pipe->endTs - pipe->startTs,
+                    strlen(pipe->sql));
+}
+
+// wait for the statement in flight in the slot, if any, so its buffer
+// can be filled again. a failure is retried synchronously
+static int32_t waitCreateSql(threadInfo *pThreadInfo, SCreateTuner *tuner,
+                             SBenchPipe *pipe) {
+    if (!pipe->inflight) {
+        return 0;
+    }
+    pthread_mutex_lock(&pipe->lock);
+    while (!pipe->done) {
+        pthread_cond_wait(&pipe->cond, &pipe->lock);
+    }
+    pthread_mutex_unlock(&pipe->lock);
+    pipe->inflight = false;
+
+    int32_t code = pipe->code;
+    if (code) {
+        printErrCmdCodeStr(pipe->sql, code, pipe->res);
+        if (g_arguments->keep_trying) {
+            code = execCreateSql(pThreadInfo, pipe->sql,
+                                 g_arguments->keep_trying);
+            pipe->endTs = benchGetMonotonicUs();
+        }
+    } else {
+        taos_free_result(pipe->res);
+    }
+    pipe->res = NULL;
+    if (code) {
+        return code;
+    }
+    accountCreateSql(pThreadInfo, tuner, pipe);
+    return 0;
+}
+
+static int32_t submitCreateSql(threadInfo *pThreadInfo, SCreateTuner *tuner,
+                               SBenchPipe *pipe, bool async,
+                               int64_t tables) {
+    debugPrint("creating table: %s\n", pipe->sql);
+    pipe->rows = tables;
+    pipe->startTs = benchGetMonotonicUs();
+    if (async) {
+        pipe->done = false;
+        pipe->inflight = true;
+        taos_query_a(pThreadInfo->conn->taos, pipe->sql,
+                     pipelinedCallback, pipe);
+        return 0;
+    }
+    int32_t ret = execCreateSql(pThreadInfo, pipe->sql,
+                                g_arguments->keep_trying);
+    if (ret) {
+        return ret;
+    }
+    pipe->endTs = benchGetMonotonicUs();
+    accountCreateSql(pThreadInfo, tuner, pipe);
+    return 0;
+}
+
 static void *createTable(void *sarg) {
     if (g_arguments->supplementInsert) {
         return NULL;
@@ -571,8 +697,28 @@ static void *createTable(void *sarg) {
 #ifdef LINUX
     prctl(PR_SET_NAME, "createTable");
 #endif
-    uint64_t lastPrintTime = toolsGetTimestampMs();
-    pThreadInfo->buffer = benchCalloc(1, TSDB_MAX_SQL_LEN, false);
+    benchBindThread(pThreadInfo->threadID);
+    benchRandSetStream((uint64_t)pThreadInfo->threadID + 1);
+
+    // statements go out asynchronously on the native connection only
+    bool    async = g_arguments->create_depth > 1
+        && REST_IFACE != stbInfo->iface;
+#ifdef WEBSOCKET
+    async = async && !g_arguments->websocket;
+#endif
+    int32_t depth = async ? g_arguments->create_depth : 1;
+    SBenchPipe *pipes = benchCalloc(depth, sizeof(SBenchPipe), false);
+    for (int32_t d = 0; d < depth; d++) {
+        pipes[d].sql = benchCalloc(1, TSDB_MAX_SQL_LEN, false);
+        pthread_mutex_init(&pipes[d].lock, NULL);
+        pthread_cond_init(&pipes[d].cond, NULL);
+    }
+    int32_t      slot = 0;
+    char *       sql = pipes[0].sql;
+    SCreateTuner tuner = {0};
+    tuner.adaptive = stbInfo->batchCreateAuto;
+    tuner.batch = tuner.adaptive ? DEFAULT_CREATE_BATCH
+        : (int64_t)stbInfo->batchCreateTableNum;
     int len = 0;
     int batchNum = 0;
     infoPrint(
@@ -593,14 +739,14 @@ static void *createTable(void *sarg) {
         }
         if (!stbInfo->use_metric || stbInfo->tags->size == 0) {
             if (stbInfo->childTblCount == 1) {
-                snprintf(pThreadInfo->buffer, TSDB_MAX_SQL_LEN,
+                snprintf(sql, TSDB_MAX_SQL_LEN,
                          stbInfo->escape_character
                          ? "CREATE TABLE %s.`%s` %s;"
                          : "CREATE TABLE %s.%s %s;",
                          database->dbName, stbInfo->stbName,
                          stbInfo->colsOfCreateChildTable);
             } else {
-                snprintf(pThreadInfo->buffer, TSDB_MAX_SQL_LEN,
+                snprintf(sql, TSDB_MAX_SQL_LEN,
                          stbInfo->escape_character
                          ? "CREATE TABLE %s.`%s%" PRIu64 "` %s;"
                          : "CREATE TABLE %s.%s%" PRIu64 " %s;",
@@ -611,21 +757,20 @@ static void *createTable(void *sarg) {
         } else {
             if (0 == len) {
                 batchNum = 0;
-                memset(pThreadInfo->buffer, 0, TSDB_MAX_SQL_LEN);
-                len += snprintf(pThreadInfo->buffer + len,
+                len += snprintf(sql + len,
                                 TSDB_MAX_SQL_LEN - len, "CREATE TABLE ");
             }
 
             len += snprintf(
-                pThreadInfo->buffer + len, TSDB_MAX_SQL_LEN - len,
+                sql + len, TSDB_MAX_SQL_LEN - len,
                 stbInfo->escape_character ? "%s.`%s%" PRIu64
                                             "` USING %s.`%s` TAGS (%s) %s "
                                           : "%s.%s%" PRIu64
                                             " USING %s.%s TAGS (%s) %s ",
                 database->dbName, stbInfo->childTblPrefix, i, database->dbName,
-                stbInfo->stbName, stbInfo->tagDataBuf + i * stbInfo->lenOfTags, ttl);
+                stbInfo->stbName, getTagData(stbInfo, i), ttl);
             batchNum++;
-            if ((batchNum < stbInfo->batchCreateTableNum) &&
+            if ((batchNum < tuner.batch) &&
                 ((TSDB_MAX_SQL_LEN - len) >=
                  (stbInfo->lenOfTags + EXTRA_SQL_LEN))) {
                 continue;
@@ -633,69 +778,92 @@ static void *createTable(void *sarg) {
         }
 
         len = 0;
-
-        int ret = 0;
-        debugPrint("creating table: %s\n", pThreadInfo->buffer);
-        if (REST_IFACE == stbInfo->iface) {
-            ret = queryDbExecRest(pThreadInfo->buffer,
-                                  database->dbName,
-                                  database->precision,
-                                  stbInfo->iface,
-                                  stbInfo->lineProtocol,
-                                  stbInfo->tcpTransfer,
-                                  pThreadInfo->sockfd);
-        } else {
-            ret = queryDbExec(pThreadInfo->conn, pThreadInfo->buffer);
-            int32_t trying = g_arguments->keep_trying;
-            while (ret && trying) {
-                infoPrint("will sleep %"PRIu32" milliseconds then re-create "
-                          "table %s\n",
-                          g_arguments->trying_interval, pThreadInfo->buffer);
-                toolsMsleep(g_arguments->trying_interval);
-                ret = queryDbExec(pThreadInfo->conn, pThreadInfo->buffer);
-                if (trying != -1) {
-                    trying --;
-                }
-            }
-        }
-        if (0 != ret) {
+        if (submitCreateSql(pThreadInfo, &tuner, pipes + slot, async,
+                            batchNum)) {
             g_fail = true;
             goto create_table_end;
         }
-        pThreadInfo->tables_created += batchNum;
         batchNum = 0;
-        uint64_t currentPrintTime = toolsGetTimestampMs();
-        if (currentPrintTime - lastPrintTime > PRINT_STAT_INTERVAL) {
-            infoPrint(
-                       "thread[%d] already created %" PRId64 " tables\n",
-                       pThreadInfo->threadID, pThreadInfo->tables_created);
-            lastPrintTime = currentPrintTime;
+        // the next statement is built while this one is in flight
+        slot = (slot + 1) % depth;
+        if (waitCreateSql(pThreadInfo, &tuner, pipes + slot)) {
+            g_fail = true;
+            goto create_table_end;
         }
+        sql = pipes[slot].sql;
     }
 
     if (0 != len) {
-        int ret = 0;
-        if (REST_IFACE == stbInfo->iface) {
-            ret = queryDbExecRest(pThreadInfo->buffer,
-                                  database->dbName,
-                                  database->precision,
-                                  stbInfo->iface,
-                                  stbInfo->lineProtocol,
-                                  stbInfo->tcpTransfer,
-                                  pThreadInfo->sockfd);
-        } else {
-            ret = queryDbExec(pThreadInfo->conn, pThreadInfo->buffer);
-        }
-        if (0 != ret) {
+        if (submitCreateSql(pThreadInfo, &tuner, pipes + slot, async,
+                            batchNum)) {
             g_fail = true;
             goto create_table_end;
         }
-        pThreadInfo->tables_created += batchNum;
-        debugPrint("thread[%d] already created %" PRId64 " tables\n",
-                   pThreadInfo->threadID, pThreadInfo->tables_created);
     }
+    for (int32_t d = 0; d < depth; d++) {
+        if (waitCreateSql(pThreadInfo, &tuner, pipes + d)) {
+            g_fail = true;
+        }
+    }
+    debugPrint("thread[%d] already created %" PRId64 " tables, "
+               "%" PRId64 " table(s) per statement at last\n",
+               pThreadInfo->threadID, pThreadInfo->tables_created,
+               tuner.batch);
 create_table_end:
-    tmfree(pThreadInfo->buffer);
+    for (int32_t d = 0; d < depth; d++) {
+        // nothing may still write into a buffer that is freed
+        if (pipes[d].inflight) {
+            pthread_mutex_lock(&pipes[d].lock);
+            while (!pipes[d].done) {
+                pthread_cond_wait(&pipes[d].cond, &pipes[d].lock);
+            }
+            pthread_mutex_unlock(&pipes[d].lock);
+            if (pipes[d].res) {
+                taos_free_result(pipes[d].res);
+            }
+        }
+        tmfree(pipes[d].sql);
+        pthread_mutex_destroy(&pipes[d].lock);
+        pthread_cond_destroy(&pipes[d].cond);
+    }
+    tmfree(pipes);
+    benchHttpRelease();
+    releaseTagData();
+    return NULL;
+}
+
+typedef struct SCreateReporter_S {
+    threadInfo *  infos;
+    int           threads;
+    int64_t       total;
+    pthread_t     pid;
+    bool volatile stop;
+} SCreateReporter;
+
+static void *createTableReporter(void *sarg) {
+    SCreateReporter *reporter = (SCreateReporter *)sarg;
+    int64_t intervalUs = (int64_t)(g_arguments->report_interval > 0
+                                   ? g_arguments->report_interval
+                                   : LIVE_REPORT_INTERVAL) * 1000000;
+    int64_t last = 0;
+    int64_t lastTs = benchGetMonotonicUs();
+
+    while (!reporter->stop && !g_arguments->terminate) {
+        int64_t now = benchGetMonotonicUs();
+        if (now - lastTs < intervalUs) {
+            toolsMsleep(100);
+            continue;
+        }
+        int64_t cur = 0;
+        for (int i = 0; i < reporter->threads; i++) {
+            cur += atomic_add_fetch_64(&reporter->infos[i].statRows, 0);
+        }
+        infoPrint("created %" PRId64 " of %" PRId64 " table(s), "
+                  "%.2f tables/second\n", cur, reporter->total,
+                  (cur - last) / ((now - lastTs) / 1E6));
+        last = cur;
+        lastTs = now;
+    }
     return NULL;
 }
 
@@ -756,10 +924,25 @@ static int startMultiThreadCreateChildTable(
             pthread_create(pids + i, NULL, createTable, pThreadInfo);
     }
 
+    SCreateReporter reporter = {0};
+    reporter.infos = infos;
+    reporter.threads = threads;
+    reporter.total = ntables;
+    // progress is only informative, go on without it if it fails
+    bool reporting = true;
+    if (pthread_create(&reporter.pid, NULL, createTableReporter, &reporter)) {
+        warnPrint("%s() failed to create reporter thread\n", __func__);
+        reporting = false;
+    }
+
     for (int i = 0; i < threads; i++) {
         if (!g_arguments->terminate)
             pthread_join(pids[i], NULL);
     }
+    if (reporting) {
+        reporter.stop = true;
+        pthread_join(reporter.pid, NULL);
+    }
 
     for (int i = 0; i < threads; i++) {
         threadInfo *pThreadInfo = infos + i;
@@ -823,15 +1006,19 @@ static int createChildTables() {
             "Spent %.4f seconds to create %" PRId64
             " table(s) with %d thread(s), already exist %" PRId64
             " table(s), actual %" PRId64 " table(s) pre created, %" PRId64
-            " table(s) will be auto created\n",
+            " table(s) will be auto created, %.2f tables/second\n",
             (end - start) / 1000.0, g_arguments->totalChildTables,
             g_arguments->table_threads, g_arguments->existedChildTables,
             g_arguments->actualChildTables,
-            g_arguments->autoCreatedChildTables);
+            g_arguments->autoCreatedChildTables,
+            end > start
+                ? g_arguments->actualChildTables * 1000.0 / (end - start)
+                : 0);
     return 0;
 }
 
 void postFreeResource() {
+    benchConnPoolDestroy();
     tmfree(g_arguments->base64_buf);
     tmfclose(g_arguments->fpOfInsertResult);
     for (int i = 0; i < g_arguments->databases->size; i++) {
@@ -850,6 +1037,14 @@ void postFreeResource() {
                 SSuperTable * stbInfo = benchArrayGet(database->superTbls, j);
                 tmfree(stbInfo->colsOfCreateChildTable);
                 tmfree(stbInfo->sampleDataBuf);
+                if (stbInfo->sampleNodeBuf) {
+                    for (int n = 0; n < TOOLS_MAX_NODES; n++) {
+                        tmfree(stbInfo->sampleNodeBuf[n]);
+                    }
+                    tmfree(stbInfo->sampleNodeBuf);
+                }
+                benchCsvClose(stbInfo->sampleCsv);
+                benchCsvClose(stbInfo->tagsCsv);
                 tmfree(stbInfo->tagDataBuf);
                 tmfree(stbInfo->partialColNameBuf);
                 for (int k = 0; k < stbInfo->tags->size; ++k) {
@@ -862,28 +1057,20 @@ void postFreeResource() {
                     Field * col = benchArrayGet(stbInfo->cols, k);
                     tmfree(col->data);
                     tmfree(col->is_null);
+                    tmfree(col->lengths);
+                    tmfree(col->gen.zipfCdf);
                 }
                 benchArrayDestroy(stbInfo->cols);
-                if (g_arguments->test_mode == INSERT_TEST &&
-                        stbInfo->insertRows != 0) {
-                    for (int64_t k = 0; k < stbInfo->childTblCount;
-                        ++k) {
-                        if (stbInfo->childTblName) {
-                            tmfree(stbInfo->childTblName[k]);
-                        }
-                    }
-                }
                 tmfree(stbInfo->childTblName);
+                benchArenaDestroy(stbInfo->childTblNameArena);
                 benchArrayDestroy(stbInfo->tsmas);
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
                 if ((0 == stbInfo->interlaceRows)
                         && (g_arguments->nthreads_auto)) {
                     for (int32_t v = 0; v < database->vgroups; v++) {
                         SVGroup *vg = benchArrayGet(database->vgArray, v);
-                        for (int64_t t = 0; t < vg->tbCountPerVgId; t ++) {
-                            tmfree(vg->childTblName[t]);
-                        }
                         tmfree(vg->childTblName);
+                        vg->childTblName = NULL;
                     }
                     benchArrayDestroy(database->vgArray);
                 }
@@ -897,11 +1084,122 @@ void postFreeResource() {
     tools_cJSON_Delete(root);
 }
 
-static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
+// Make lines[] and the arena hold requests of batch rows. Only called
+// between requests; in auto mode they start at the first size tried and
+// grow with the tuner instead of being allocated at the ceiling.
+static void reserveSmlBuffers(threadInfo *pThreadInfo, uint32_t batch) {
+    SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    if (batch <= pThreadInfo->smlBatchCap) {
+        return;
+    }
+    tmfree(pThreadInfo->lines);
+    tmfree(pThreadInfo->buffer);
+    if (stbInfo->lineProtocol != TSDB_SML_JSON_PROTOCOL) {
+        pThreadInfo->lines = benchCalloc(batch, sizeof(char *), true);
+        // room for "put " and a terminator per line plus the closing NUL
+        pThreadInfo->bufferSize =
+            (uint64_t)batch * (5 + pThreadInfo->max_sql_len) + 1;
+    } else {
+        pThreadInfo->lines = benchCalloc(1, sizeof(char *), true);
+        // records are streamed into one reusable JSON array
+        pThreadInfo->bufferSize = (uint64_t)batch
+            * (1 + smlJsonTagsLen(stbInfo) + smlJsonColsLen(stbInfo)) + 3;
+    }
+    pThreadInfo->buffer = benchCalloc(1, pThreadInfo->bufferSize, true);
+    pThreadInfo->smlBatchCap = batch;
+}
+
+// Append one schemaless line to the thread arena. Each line keeps its own
+// NUL terminator so lines[] can be handed to taos_schemaless_insert as is;
+// the telnet "put " prefix is written in place for the TCP transfer.
+static void appendSmlLine(threadInfo *pThreadInfo, int j,
+                          const char *tags, const char *cols,
+                          int32_t colsLen, int64_t ts) {
+    SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    char *line = pThreadInfo->buffer + pThreadInfo->lineLen;
+    int   cap = stbInfo->lenOfCols + stbInfo->lenOfTags;
+    int   len = 0;
+    int   n;
+
+    if (stbInfo->iface == SML_REST_IFACE
+            && stbInfo->lineProtocol == TSDB_SML_TELNET_PROTOCOL
+            && stbInfo->tcpTransfer) {
+        len = sprintf(line, "put ");
+    }
+    if (stbInfo->lineProtocol == TSDB_SML_LINE_PROTOCOL) {
+        n = snprintf(line + len, cap, "%s %.*s %" PRId64 "",
+                     tags, colsLen, cols, ts);
+    } else {
+        n = snprintf(line + len, cap, "%s %" PRId64 " %.*s %s",
+                     stbInfo->stbName, ts, colsLen, cols, tags);
+    }
+    len += (n < cap) ? n : cap - 1;
+    pThreadInfo->lines[j] = line;
+    pThreadInfo->lineLen += len + 1;
+}
+
+// Turn the packed arena into a newline separated request body in place.
+static uint64_t joinSmlLines(threadInfo *pThreadInfo, uint32_t k) {
+    for (uint32_t i = 1; i < k; i++) {
+        pThreadInfo->lines[i][-1] = '\n';
+    }
+    if (pThreadInfo->lineLen) {
+        pThreadInfo->buffer[pThreadInfo->lineLen - 1] = '\n';
+    }
+    pThreadInfo->buffer[pThreadInfo->lineLen] = '\0';
+    return pThreadInfo->lineLen;
+}
+
+// Tag fragment of table tableSeq for the OpenTSDB JSON writer. It is
+// serialised when the table is reached, from a random stream of the
+// table's own like getTagData(), and kept while the thread stays on it.
+static char *getSmlJsonTags(threadInfo *pThreadInfo, uint64_t tableSeq) {
+    if (pThreadInfo->smlJsonTags && pThreadInfo->smlJsonTagsSeq == tableSeq) {
+        return pThreadInfo->smlJsonTags;
+    }
+    tmfree(pThreadInfo->smlJsonTags);
+    SBenchRand rand;
+    benchRandSeed(&rand, g_arguments->random_seed,
+                  ((uint64_t)2 << 32) + tableSeq);
+    SBenchRand *prev = benchRandBind(&rand);
+    pThreadInfo->smlJsonTags =
+        generateSmlJsonTags(pThreadInfo->stbInfo, tableSeq, 0);
+    benchRandBind(prev);
+    pThreadInfo->smlJsonTagsSeq = tableSeq;
+    return pThreadInfo->smlJsonTags;
+}
+
+// Append one OpenTSDB JSON record of table tableSeq to the arena.
+static void appendSmlJson(threadInfo *pThreadInfo, uint64_t tableSeq,
+                          int64_t ts) {
+    char *tags = getSmlJsonTags(pThreadInfo, tableSeq);
+    char *buf = pThreadInfo->buffer + pThreadInfo->lineLen;
+    *buf++ = pThreadInfo->lineLen ? ',' : '[';
+    pThreadInfo->lineLen += 1 + generateSmlJsonCols(
+            buf, tags, pThreadInfo->stbInfo,
+            pThreadInfo->dbInfo->sml_precision, ts);
+}
+
+// Close the JSON array in the arena and hand it out as lines[0].
+static uint64_t closeSmlJson(threadInfo *pThreadInfo) {
+    if (pThreadInfo->lineLen == 0) {
+        pThreadInfo->buffer[pThreadInfo->lineLen++] = '[';
+    }
+    pThreadInfo->buffer[pThreadInfo->lineLen++] = ']';
+    pThreadInfo->buffer[pThreadInfo->lineLen] = '\0';
+    pThreadInfo->lines[0] = pThreadInfo->buffer;
+    return pThreadInfo->lineLen;
+}
+
+// len is the length of the SQL text in buffer for taosc and rest, the
+// writers know it already
+static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k,
+                          uint64_t len) {
     SDataBase *  database = pThreadInfo->dbInfo;
     SSuperTable *stbInfo = pThreadInfo->stbInfo;
     TAOS_RES *   res = NULL;
     int32_t      code = 0;
+    int64_t      bytes = 0;
     uint16_t     iface = stbInfo->iface;
 
     int32_t trying = (stbInfo->keep_trying)?
@@ -912,8 +1210,10 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
     switch (iface) {
         case TAOSC_IFACE:
             debugPrint("buffer: %s\n", pThreadInfo->buffer);
+            bytes = len;
             code = queryDbExec(pThreadInfo->conn, pThreadInfo->buffer);
             while (code && trying) {
+                atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
                 infoPrint("will sleep %"PRIu32" milliseconds then re-insert\n",
                           trying_interval);
                 toolsMsleep(trying_interval);
@@ -926,7 +1226,9 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
 
         case REST_IFACE:
             debugPrint("buffer: %s\n", pThreadInfo->buffer);
+            bytes = len;
             code = postProceSql(pThreadInfo->buffer,
+                                len,
                                 database->dbName,
                                 database->precision,
                                 stbInfo->iface,
@@ -936,10 +1238,12 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
                                 pThreadInfo->sockfd,
                                 pThreadInfo->filePath);
             while (code && trying) {
+                atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
                 infoPrint("will sleep %"PRIu32" milliseconds then re-insert\n",
                           trying_interval);
                 toolsMsleep(trying_interval);
                 code = postProceSql(pThreadInfo->buffer,
+                                    len,
                                     database->dbName,
                                     database->precision,
                                     stbInfo->iface,
@@ -965,6 +1269,11 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
             break;
 
         case SML_IFACE:
+            if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
+                bytes = closeSmlJson(pThreadInfo);
+            } else {
+                bytes = pThreadInfo->lineLen - k;
+            }
             res = taos_schemaless_insert(
                 pThreadInfo->conn->taos, pThreadInfo->lines,
                 stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL ? 0 : k,
@@ -975,6 +1284,7 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
             code = taos_errno(res);
             trying = stbInfo->keep_trying;
             while (code && trying) {
+                atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
                 infoPrint("will sleep %"PRIu32" milliseconds then re-insert\n",
                           trying_interval);
                 toolsMsleep(trying_interval);
@@ -1003,30 +1313,17 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
 
         case SML_REST_IFACE: {
             if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                pThreadInfo->lines[0] = tools_cJSON_Print(pThreadInfo->json_array);
-                code = postProceSql(pThreadInfo->lines[0], database->dbName,
+                bytes = closeSmlJson(pThreadInfo);
+                code = postProceSql(pThreadInfo->lines[0], bytes,
+                                    database->dbName,
                                     database->precision, stbInfo->iface,
                                     stbInfo->lineProtocol, g_arguments->port,
                                     stbInfo->tcpTransfer,
                                     pThreadInfo->sockfd, pThreadInfo->filePath);
             } else {
-                int len = 0;
-                for (int i = 0; i < k; ++i) {
-                    if (strlen(pThreadInfo->lines[i]) != 0) {
-                        if (stbInfo->lineProtocol == TSDB_SML_TELNET_PROTOCOL
-                            && stbInfo->tcpTransfer) {
-                            len += sprintf(pThreadInfo->buffer + len,
-                                           "put %s\n", pThreadInfo->lines[i]);
-                        } else {
-                            len += sprintf(pThreadInfo->buffer + len, "%s\n",
-                                           pThreadInfo->lines[i]);
-                        }
-                    } else {
-                        break;
-                    }
-                }
-                code = postProceSql(pThreadInfo->buffer, database->dbName,
-                        database->precision,
+                bytes = joinSmlLines(pThreadInfo, k);
+                code = postProceSql(pThreadInfo->buffer, bytes,
+                        database->dbName, database->precision,
                         stbInfo->iface, stbInfo->lineProtocol,
                         g_arguments->port,
                         stbInfo->tcpTransfer,
@@ -1035,13 +1332,701 @@ static int32_t execInsert(threadInfo *pThreadInfo, uint32_t k) {
             break;
         }
     }
+    if (code) {
+        atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
+    } else {
+        atomic_add_fetch_64(&pThreadInfo->statBytes, bytes);
+        atomic_add_fetch_64(&pThreadInfo->statWireBytes,
+                            (stbInfo->iface == REST_IFACE
+                             || stbInfo->iface == SML_REST_IFACE)
+                            ? benchHttpLastWireLen() : bytes);
+    }
     return code;
 }
 
+static void recordInsertStat(threadInfo *pThreadInfo,
+                             int64_t rows, int64_t delay) {
+    atomic_add_fetch_64(&pThreadInfo->statRows, rows);
+    atomic_add_fetch_64(&pThreadInfo->statRequests, 1);
+    if (pThreadInfo->statHist && delay > 0) {
+        benchHistRecordAtomic(pThreadInfo->statHist, delay);
+    }
+}
+
+// a target rate in total is one schedule shared by the insert threads,
+// each request claims the next slots of it, so the rate still holds
+// when some threads run out of tables before the others
+static int64_t          g_rateStartUs;
+static int64_t volatile g_rateUnits;
+
+// open-loop pacing: wait for the scheduled send time of the request of
+// rows and return it, so latency can include the time a late request
+// spent queued behind a slow one. returns 0 when no target rate is set.
+static int64_t waitIntendedTs(threadInfo *pThreadInfo, int64_t rows) {
+    if (pThreadInfo->rateUnitUs <= 0) {
+        return 0;
+    }
+    int64_t units = g_arguments->rate_by_requests ? 1 : rows;
+    int64_t start;
+    int64_t slot;
+    if (g_arguments->rate_per_thread) {
+        if (0 == pThreadInfo->rateStartUs) {
+            pThreadInfo->rateStartUs = benchGetMonotonicUs();
+        }
+        start = pThreadInfo->rateStartUs;
+        slot = pThreadInfo->rateUnits;
+        pThreadInfo->rateUnits += units;
+    } else {
+        start = g_rateStartUs;
+        slot = atomic_add_fetch_64(&g_rateUnits, units) - units;
+    }
+    int64_t intendedTs = start + (int64_t)(slot * pThreadInfo->rateUnitUs);
+    benchSleepUntilUs(intendedTs);
+    return intendedTs;
+}
+
+// num_of_records_per_req "auto": all insert threads of a super table
+// share one batch size. it doubles from AUTO_REQ_PER_REQ_START while the
+// rows/s of the process improve, then the neighbours of the best size
+// are measured once and the best size is kept for the rest of the run
+#define AUTO_REQ_STEP_US    (2 * 1000000)
+#define AUTO_REQ_SETTLE_US  (500 * 1000)
+#define AUTO_REQ_POINTS     32
+
+typedef struct SReqTunePoint_S {
+    uint32_t batch;
+    double   rowsPerSec;
+    double   avgDelayMs;
+    double   rowsPerReq;  // below batch when max sql length cut it
+} SReqTunePoint;
+
+typedef struct SReqTuner_S {
+    pthread_mutex_t   lock;
+    bool              active;
+    bool volatile     settled;
+    uint32_t volatile batch;  // size of the next request built
+    uint32_t          ceiling;
+    int64_t           stepStart;
+    int64_t           rows;
+    int64_t           requests;
+    int64_t           delaySum;
+    bool              refining;
+    uint32_t          pending[2];
+    int32_t           pendingCount;
+    int32_t           best;
+    int32_t           count;
+    SReqTunePoint     points[AUTO_REQ_POINTS];
+} SReqTuner;
+
+static SReqTuner     g_reqTuner = {.lock = PTHREAD_MUTEX_INITIALIZER};
+static bool volatile g_sqlLenCapWarned;
+
+static uint32_t insertBatchSize() {
+    return g_reqTuner.active ? g_reqTuner.batch : g_arguments->reqPerReq;
+}
+
+static void startReqTuner(SSuperTable *stbInfo) {
+    memset(g_reqTuner.points, 0, sizeof(g_reqTuner.points));
+    g_reqTuner.active = g_arguments->reqPerReqAuto;
+    g_reqTuner.settled = false;
+    g_reqTuner.ceiling = g_arguments->reqPerReq;
+    g_reqTuner.batch = min(AUTO_REQ_PER_REQ_START, g_reqTuner.ceiling);
+    g_reqTuner.stepStart = benchGetMonotonicUs();
+    g_reqTuner.rows = 0;
+    g_reqTuner.requests = 0;
+    g_reqTuner.delaySum = 0;
+    g_reqTuner.refining = false;
+    g_reqTuner.pendingCount = 0;
+    g_reqTuner.best = -1;
+    g_reqTuner.count = 0;
+    if (g_reqTuner.active) {
+        infoPrint("auto-tuning records per request for %s between %u "
+                  "and %u\n", stbInfo->stbName, g_reqTuner.batch,
+                  g_reqTuner.ceiling);
+    }
+}
+
+// a clearly higher rate wins, a comparable one wins on latency
+static bool betterReqPoint(SReqTunePoint *a, SReqTunePoint *b) {
+    if (a->rowsPerSec > b->rowsPerSec * 1.02) {
+        return true;
+    }
+    return a->rowsPerSec >= b->rowsPerSec * 0.98
+        && a->avgDelayMs < b->avgDelayMs;
+}
+
+static bool measuredReqBatch(SReqTuner *t, uint32_t batch) {
+    for (int32_t i = 0; i < t->count; i++) {
+        if (t->points[i].batch == batch) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// close the running step and pick the size of the next one
+static void stepReqTuner(SReqTuner *t, int64_t now) {
+    SReqTunePoint *p = t->points + t->count;
+    double seconds = (now - t->stepStart - AUTO_REQ_SETTLE_US) / 1E6;
+    p->batch = t->batch;
+    p->rowsPerSec = t->rows / seconds;
+    p->avgDelayMs = t->delaySum / 1E3 / t->requests;
+    p->rowsPerReq = (double)t->rows / t->requests;
+    if (t->best < 0 || betterReqPoint(p, t->points + t->best)) {
+        t->best = t->count;
+    }
+    t->count++;
+
+    SReqTunePoint *best = t->points + t->best;
+    // requests that come out shorter than asked for hit a hard limit
+    bool capped = best->rowsPerReq < 0.9 * best->batch;
+    if (!t->refining) {
+        if (best == p && !capped && (uint64_t)t->batch * 2 <= t->ceiling) {
+            t->batch *= 2;
+            goto next_step;
+        }
+        t->refining = true;
+        uint32_t up = best->batch + best->batch / 2;
+        uint32_t down = best->batch - best->batch / 4;
+        if (!capped && up <= t->ceiling && !measuredReqBatch(t, up)) {
+            t->pending[t->pendingCount++] = up;
+        }
+        if (down > 0 && !measuredReqBatch(t, down)) {
+            t->pending[t->pendingCount++] = down;
+        }
+    }
+    if (t->pendingCount > 0 && t->count < AUTO_REQ_POINTS) {
+        t->batch = t->pending[--t->pendingCount];
+        goto next_step;
+    }
+    t->batch = best->batch;
+    t->settled = true;
+    infoPrint("records per request settled on %u, %.2f records/second\n",
+              best->batch, best->rowsPerSec);
+next_step:
+    t->stepStart = now;
+    t->rows = 0;
+    t->requests = 0;
+    t->delaySum = 0;
+}
+
+static void tuneReqPerReq(int64_t rows, int64_t delay) {
+    if (!g_reqTuner.active || g_reqTuner.settled) {
+        return;
+    }
+    pthread_mutex_lock(&g_reqTuner.lock);
+    int64_t now = benchGetMonotonicUs();
+    // requests built with the previous size are still draining
+    if (!g_reqTuner.settled
+            && now - g_reqTuner.stepStart >= AUTO_REQ_SETTLE_US) {
+        g_reqTuner.rows += rows;
+        g_reqTuner.requests++;
+        g_reqTuner.delaySum += delay;
+        if (now - g_reqTuner.stepStart >= AUTO_REQ_STEP_US) {
+            stepReqTuner(&g_reqTuner, now);
+        }
+    }
+    pthread_mutex_unlock(&g_reqTuner.lock);
+}
+
+static void reportReqTuner(SSuperTable *stbInfo) {
+    if (!g_reqTuner.active) {
+        return;
+    }
+    g_reqTuner.active = false;
+    if (g_reqTuner.best < 0) {
+        infoPrint("records per request of %s: run too short to tune, "
+                  "used %u\n", stbInfo->stbName, g_reqTuner.batch);
+        return;
+    }
+    SReqTunePoint *best = g_reqTuner.points + g_reqTuner.best;
+    FILE *fp = g_arguments->fpOfInsertResult;
+    infoPrint("records per request of %s %s %u, measured:\n",
+              stbInfo->stbName,
+              g_reqTuner.settled ? "settled on" : "not settled, best so far",
+              best->batch);
+    if (fp) {
+        infoPrintToFile(fp, "records per request of %s %s %u, measured:\n",
+                        stbInfo->stbName,
+                        g_reqTuner.settled ? "settled on"
+                                           : "not settled, best so far",
+                        best->batch);
+    }
+    for (int32_t i = 0; i < g_reqTuner.count; i++) {
+        SReqTunePoint *p = g_reqTuner.points + i;
+        infoPrint("  %6u records/request: %.2f records/second, "
+                  "average delay %.2fms, %.1f records sent per request%s\n",
+                  p->batch, p->rowsPerSec, p->avgDelayMs, p->rowsPerReq,
+                  p == best ? " <- best" : "");
+        if (fp) {
+            infoPrintToFile(fp, "  %6u records/request: %.2f records/second, "
+                            "average delay %.2fms, %.1f records sent per "
+                            "request%s\n",
+                            p->batch, p->rowsPerSec, p->avgDelayMs,
+                            p->rowsPerReq, p == best ? " <- best" : "");
+        }
+    }
+}
+
+// a progressive batch cut short by the statement buffer, say so once
+static void warnSqlLenCap(uint32_t generated, uint32_t batch) {
+    if (g_sqlLenCapWarned || g_arguments->reqPerReqAuto) {
+        return;
+    }
+    g_sqlLenCapWarned = true;
+    warnPrint("records per request (%u) is capped to %u by max sql length "
+              "(%d)\n", batch, generated, MAX_SQL_LEN);
+}
+
+static void recordInsertDelay(threadInfo *pThreadInfo, int64_t rows,
+                              int64_t intendedTs,
+                              int64_t startTs, int64_t endTs) {
+    int64_t delay = endTs - startTs;
+    int64_t latency = intendedTs ? endTs - intendedTs : delay;
+    pThreadInfo->totalInsertRows += rows;
+    tuneReqPerReq(rows, delay);
+    if (delay <= 0) {
+        debugPrint("thread[%d]: startTs: %"PRId64", endTs: %"PRId64"\n",
+                   pThreadInfo->threadID, startTs, endTs);
+    } else {
+        perfPrint("insert execution time is %.6f s\n", delay / 1E6);
+        benchHistRecord(pThreadInfo->delayHist, latency);
+        pThreadInfo->totalDelay += delay;
+    }
+    recordInsertStat(pThreadInfo, rows, latency);
+}
+
+static void pipelinedCallback(void *param, TAOS_RES *res, int code) {
+    SBenchPipe *pipe = (SBenchPipe *)param;
+    pthread_mutex_lock(&pipe->lock);
+    pipe->endTs = benchGetMonotonicUs();
+    pipe->res = res;
+    pipe->code = code;
+    pipe->done = true;
+    pthread_cond_signal(&pipe->cond);
+    pthread_mutex_unlock(&pipe->lock);
+}
+
+// wait for the request in flight, if any, and account for it. a failed
+// request is retried synchronously with the same keep trying policy as
+// execInsert()
+static int32_t waitPipelined(threadInfo *pThreadInfo) {
+    SBenchPipe *pipe = pThreadInfo->pipe;
+    if (!pipe->inflight) {
+        return 0;
+    }
+    pthread_mutex_lock(&pipe->lock);
+    while (!pipe->done) {
+        pthread_cond_wait(&pipe->cond, &pipe->lock);
+    }
+    pthread_mutex_unlock(&pipe->lock);
+    pipe->inflight = false;
+
+    int32_t code = pipe->code;
+    if (code) {
+        printErrCmdCodeStr(pipe->sql, code, pipe->res);
+        SSuperTable *stbInfo = pThreadInfo->stbInfo;
+        int32_t trying = (stbInfo->keep_trying)?
+            stbInfo->keep_trying:g_arguments->keep_trying;
+        int32_t trying_interval = stbInfo->trying_interval?
+            stbInfo->trying_interval:g_arguments->trying_interval;
+        while (code && trying) {
+            atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
+            infoPrint("will sleep %"PRIu32" milliseconds then re-insert\n",
+                      trying_interval);
+            toolsMsleep(trying_interval);
+            code = queryDbExec(pThreadInfo->conn, pipe->sql);
+            if (trying != -1) {
+                trying --;
+            }
+        }
+        pipe->endTs = benchGetMonotonicUs();
+    } else {
+        taos_free_result(pipe->res);
+    }
+    pipe->res = NULL;
+
+    if (code) {
+        atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
+        return code;
+    }
+    atomic_add_fetch_64(&pThreadInfo->statBytes, pipe->bytes);
+    atomic_add_fetch_64(&pThreadInfo->statWireBytes, pipe->bytes);
+    recordInsertDelay(pThreadInfo, pipe->rows, pipe->intendedTs,
+                      pipe->startTs, pipe->endTs);
+    return 0;
+}
+
+// send the batch in pThreadInfo->buffer asynchronously and hand the
+// spare buffer back, so the next batch is generated while this one is
+// in flight. only one request per thread is in flight at a time.
+static int32_t submitPipelined(threadInfo *pThreadInfo, uint64_t len,
+                               int64_t rows, int64_t intendedTs) {
+    SBenchPipe *pipe = pThreadInfo->pipe;
+    int32_t code = waitPipelined(pThreadInfo);
+    if (code) {
+        return code;
+    }
+
+    char *sql = pThreadInfo->buffer;
+    pThreadInfo->buffer = pipe->sql;
+    pipe->sql = sql;
+    pipe->bytes = len;
+    pipe->rows = rows;
+    pipe->intendedTs = intendedTs;
+    pipe->done = false;
+    pipe->inflight = true;
+    pipe->startTs = benchGetMonotonicUs();
+    debugPrint("buffer: %s\n", sql);
+    taos_query_a(pThreadInfo->conn->taos, sql, pipelinedCallback, pipe);
+    return 0;
+}
+
+static void restInsertDone(void *param, SBenchRestReq *req,
+                           int32_t code, int64_t endTs) {
+    threadInfo *pThreadInfo = (threadInfo *)param;
+    if (code) {
+        atomic_add_fetch_64(&pThreadInfo->statErrors, 1);
+        return;
+    }
+    atomic_add_fetch_64(&pThreadInfo->statBytes, req->rawLen);
+    atomic_add_fetch_64(&pThreadInfo->statWireBytes, req->bodyLen);
+    recordInsertDelay(pThreadInfo, req->rows, req->intendedTs,
+                      req->startTs, endTs);
+}
+
+// hand the batch in pThreadInfo->buffer to the REST engine, which keeps
+// several requests in flight over the thread's connections
+static int32_t submitRest(threadInfo *pThreadInfo, uint32_t k, uint64_t len,
+                          int64_t rows, int64_t intendedTs) {
+    SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    // rest passes in the length of its SQL text, lines are joined here
+    if (stbInfo->iface == SML_REST_IFACE) {
+        len = stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL
+            ? closeSmlJson(pThreadInfo) : joinSmlLines(pThreadInfo, k);
+    }
+    debugPrint("buffer: %s\n", pThreadInfo->buffer);
+    return benchRestSubmit(pThreadInfo->rest, pThreadInfo->buffer, len,
+                           rows, intendedTs);
+}
+
+// counters are cumulative, the reporter keeps the previous sample
+// and prints deltas so workers never have to reset anything
+enum {
+    STAT_ROWS,
+    STAT_REQUESTS,
+    STAT_BYTES,
+    STAT_WIRE_BYTES,
+    STAT_ERRORS,
+    STAT_COUNT
+};
+
+// multi-process mode: the coordinator creates the schema, forked workers
+// insert into their own slice of child tables and publish their counters
+// and latency into one shared memory segment read by the coordinator
+#define PROC_PUBLISH_MS       200
+
+enum {
+    PROC_WAIT,
+    PROC_GO,     // schema created, workers set up their insert threads
+    PROC_RUN,    // every worker is set up, the timed window starts
+    PROC_ABORT
+};
+
+typedef struct SBenchProcStat_S {
+    int64_t volatile stats[STAT_COUNT];
+    int32_t volatile ready;  // set up and waiting for PROC_RUN
+    pthread_mutex_t  lock;   // process shared, guards both histograms
+    SBenchHist       hist;   // latency since the last coordinator sample
+    SBenchHist       total;  // latency of the whole run
+} SBenchProcStat;
+
+typedef struct SBenchProcShm_S {
+    int32_t volatile state;
+    int32_t          count;
+    int32_t          stables;
+    SBenchProcStat   procs[];
+    // followed by one byte per stable, set when the coordinator took
+    // its schema from the server instead of the json file
+} SBenchProcShm;
+
+static SBenchProcShm  *g_procShm = NULL;
+static SBenchProcStat *g_procStat = NULL;  // own slot in a worker
+static int32_t         g_procIndex = -1;
+
+// a worker that died holding the lock must not hang the coordinator
+static void lockProcStat(SBenchProcStat *stat) {
+#ifdef LINUX
+    if (EOWNERDEAD == pthread_mutex_lock(&stat->lock)) {
+        pthread_mutex_consistent(&stat->lock);
+    }
+#else
+    pthread_mutex_lock(&stat->lock);
+#endif
+}
+
+// second barrier of a worker: its setup is done, insert threads start
+// once every worker got here. a worker without tables of a stable passes
+// on to the next one, and one that gives up calls it on its way out
+static void waitInsertWorkersReady() {
+    if (NULL == g_procStat || g_procStat->ready) {
+        return;
+    }
+    g_procStat->ready = 1;
+    while (PROC_GO == g_procShm->state && !g_arguments->terminate) {
+        toolsMsleep(1);
+    }
+}
+
+static uint8_t *procStableFromServer(int32_t stable) {
+    return (uint8_t *)(g_procShm->procs + g_procShm->count) + stable;
+}
+
+// per-interval statistics are collected for the json report and for
+// publishing to the coordinator
+static bool insertStatLive() {
+    return g_arguments->report_interval > 0 || g_procStat;
+}
+
+typedef struct SInsertReporter_S {
+    threadInfo *    infos;
+    int             threads;
+    FILE *          fp;
+    SBenchProcStat *publish;  // worker process: publish instead of print
+    SBenchHist *    prev;     // per thread statHist at the last sample
+    pthread_t       pid;
+    bool volatile   stop;
+} SInsertReporter;
+
+static void writeInsertReport(FILE *fp, SBenchHist *hist,
+                              int64_t *cur, int64_t *last,
+                              int64_t intervalUs, int64_t elapsedUs) {
+    double seconds = intervalUs > 0 ? intervalUs / 1E6 : 1;
+    fprintf(fp,
+            "{\"ts\":%" PRId64 ",\"elapsed\":%.3f,\"interval\":%.3f,"
+            "\"rows\":%" PRId64 ",\"rows_per_sec\":%.2f,"
+            "\"requests\":%" PRId64 ",\"requests_per_sec\":%.2f,"
+            "\"bytes\":%" PRId64 ",\"bytes_per_sec\":%.2f,"
+            "\"wire_bytes\":%" PRId64 ",\"wire_bytes_per_sec\":%.2f,"
+            "\"errors\":%" PRId64 ",\"total_rows\":%" PRId64 ","
+            "\"latency_ms\":{\"min\":%.3f,\"avg\":%.3f,\"p50\":%.3f,"
+            "\"p90\":%.3f,\"p99\":%.3f,\"p99.9\":%.3f,\"max\":%.3f}}\n",
+            toolsGetTimestampMs(), elapsedUs / 1E6, intervalUs / 1E6,
+            cur[STAT_ROWS] - last[STAT_ROWS],
+            (cur[STAT_ROWS] - last[STAT_ROWS]) / seconds,
+            cur[STAT_REQUESTS] - last[STAT_REQUESTS],
+            (cur[STAT_REQUESTS] - last[STAT_REQUESTS]) / seconds,
+            cur[STAT_BYTES] - last[STAT_BYTES],
+            (cur[STAT_BYTES] - last[STAT_BYTES]) / seconds,
+            cur[STAT_WIRE_BYTES] - last[STAT_WIRE_BYTES],
+            (cur[STAT_WIRE_BYTES] - last[STAT_WIRE_BYTES]) / seconds,
+            cur[STAT_ERRORS] - last[STAT_ERRORS],
+            cur[STAT_ROWS],
+            hist->count ? hist->min / 1E3 : 0,
+            benchHistMean(hist) / 1E3,
+            benchHistPercentile(hist, 50) / 1E3,
+            benchHistPercentile(hist, 90) / 1E3,
+            benchHistPercentile(hist, 99) / 1E3,
+            benchHistPercentile(hist, 99.9) / 1E3,
+            hist->max / 1E3);
+    fflush(fp);
+}
+
+// add the deltas of this sample to the worker's shared slot
+static void publishInsertStat(SBenchProcStat *stat, SBenchHist *hist,
+                              int64_t *cur, int64_t *last) {
+    for (int s = 0; s < STAT_COUNT; s++) {
+        atomic_add_fetch_64(&stat->stats[s], cur[s] - last[s]);
+    }
+    lockProcStat(stat);
+    benchHistMerge(&stat->hist, hist);
+    pthread_mutex_unlock(&stat->lock);
+}
+
+static void *insertReporter(void *sarg) {
+    SInsertReporter *reporter = (SInsertReporter *)sarg;
+    SBenchHist *hist = benchHistInit();
+    int64_t     intervalUs = reporter->publish
+        ? PROC_PUBLISH_MS * 1000
+        : (int64_t)g_arguments->report_interval * 1000000;
+    int64_t     last[STAT_COUNT] = {0};
+    int64_t     cur[STAT_COUNT];
+    int64_t     begin = benchGetMonotonicUs();
+    int64_t     lastTs = begin;
+    bool        stop = false;
+
+    while (!stop) {
+        int64_t now = benchGetMonotonicUs();
+        while (!reporter->stop && !g_arguments->terminate
+                && now - lastTs < intervalUs) {
+            int64_t left = (intervalUs - (now - lastTs)) / 1000;
+            toolsMsleep(left > 100 ? 100 : (int32_t)left + 1);
+            now = benchGetMonotonicUs();
+        }
+        stop = reporter->stop || g_arguments->terminate;
+
+        memset(cur, 0, sizeof(cur));
+        benchHistReset(hist);
+        for (int i = 0; i < reporter->threads; i++) {
+            threadInfo *pThreadInfo = reporter->infos + i;
+            cur[STAT_ROWS] +=
+                atomic_add_fetch_64(&pThreadInfo->statRows, 0);
+            cur[STAT_REQUESTS] +=
+                atomic_add_fetch_64(&pThreadInfo->statRequests, 0);
+            cur[STAT_BYTES] +=
+                atomic_add_fetch_64(&pThreadInfo->statBytes, 0);
+            cur[STAT_WIRE_BYTES] +=
+                atomic_add_fetch_64(&pThreadInfo->statWireBytes, 0);
+            cur[STAT_ERRORS] +=
+                atomic_add_fetch_64(&pThreadInfo->statErrors, 0);
+            benchHistMergeDelta(hist, pThreadInfo->statHist,
+                                reporter->prev + i);
+        }
+        if (reporter->publish) {
+            publishInsertStat(reporter->publish, hist, cur, last);
+        } else {
+            writeInsertReport(reporter->fp, hist, cur, last,
+                              now - lastTs, now - begin);
+        }
+        memcpy(last, cur, sizeof(last));
+        lastTs = now;
+    }
+    benchHistDestroy(hist);
+    return NULL;
+}
+
+static SInsertReporter *startInsertReporter(threadInfo *infos, int threads) {
+    if (g_procStat) {
+        SInsertReporter *reporter =
+            benchCalloc(1, sizeof(SInsertReporter), true);
+        reporter->infos = infos;
+        reporter->threads = threads;
+        reporter->publish = g_procStat;
+        reporter->prev = benchCalloc(threads, sizeof(SBenchHist), true);
+        if (pthread_create(&reporter->pid, NULL, insertReporter, reporter)) {
+            errorPrint("%s() failed to create publisher thread\n", __func__);
+            tmfree(reporter->prev);
+            tmfree(reporter);
+            return NULL;
+        }
+        return reporter;
+    }
+    char path[MAX_PATH_LEN];
+    snprintf(path, MAX_PATH_LEN, "%s.jsonl", g_arguments->output_file);
+    FILE *fp = fopen(path, "a");
+    if (NULL == fp) {
+        errorPrint("failed to open %s for interval report, reason: %s\n",
+                   path, strerror(errno));
+        return NULL;
+    }
+    SInsertReporter *reporter =
+        benchCalloc(1, sizeof(SInsertReporter), true);
+    reporter->infos = infos;
+    reporter->threads = threads;
+    reporter->fp = fp;
+    reporter->prev = benchCalloc(threads, sizeof(SBenchHist), true);
+    if (pthread_create(&reporter->pid, NULL, insertReporter, reporter)) {
+        errorPrint("%s() failed to create reporter thread\n", __func__);
+        fclose(fp);
+        tmfree(reporter->prev);
+        tmfree(reporter);
+        return NULL;
+    }
+    infoPrint("interval report every %d second(s) written to %s\n",
+              g_arguments->report_interval, path);
+    return reporter;
+}
+
+static void stopInsertReporter(SInsertReporter *reporter) {
+    if (NULL == reporter) {
+        return;
+    }
+    reporter->stop = true;
+    pthread_join(reporter->pid, NULL);
+    if (reporter->fp) {
+        fclose(reporter->fp);
+    }
+    tmfree(reporter->prev);
+    tmfree(reporter);
+}
+
+// place a writer, then move its buffers and the sample rows next to it
+static void placeInsertThread(threadInfo *pThreadInfo) {
+    int32_t seq = pThreadInfo->threadID;
+    if (g_procIndex > 0) {
+        // worker processes continue where the previous one stopped
+        seq += g_procIndex * g_arguments->nthreads;
+    }
+    benchBindThread(seq);
+    if (toolsThreadNode() < 0) {
+        return;
+    }
+    if (pThreadInfo->bufferSize) {
+        toolsMoveToLocalNode(pThreadInfo->buffer, pThreadInfo->bufferSize);
+        if (pThreadInfo->pipe) {
+            toolsMoveToLocalNode(pThreadInfo->pipe->sql,
+                                 pThreadInfo->bufferSize);
+        }
+    }
+    localizeSampleData(pThreadInfo->stbInfo);
+}
+
+// the part of an interlace statement before the rows of a table never
+// changes, so it is rendered once per table of the thread and appended
+// with a single copy in every round. only the thread's own range of
+// tables is kept, so the threads together hold one header per table
+static void buildInterlacePrefixes(threadInfo *pThreadInfo) {
+    SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    uint64_t     ntables = pThreadInfo->end_table_to
+        - pThreadInfo->start_table_from + 1;
+    char ttl[20] = "";
+    if (stbInfo->ttl != 0) {
+        sprintf(ttl, "TTL %d", stbInfo->ttl);
+    }
+    bool    partial = stbInfo->partialColNum != stbInfo->cols->size;
+    int64_t cap = TSDB_TABLE_NAME_LEN * 2 + strlen(stbInfo->stbName)
+        + stbInfo->lenOfTags + EXTRA_SQL_LEN
+        + (partial ? strlen(stbInfo->partialColNameBuf) : 0);
+    pThreadInfo->sqlPrefix = benchCalloc(ntables, sizeof(char *), true);
+    pThreadInfo->sqlPrefixLen = benchCalloc(ntables, sizeof(uint32_t), true);
+    pThreadInfo->sqlPrefixArena = benchArenaInit(BENCH_ARENA_CHUNK_SIZE);
+    char *prefix = benchCalloc(1, cap, true);
+    for (uint64_t t = 0; t < ntables; t++) {
+        uint64_t tableSeq = pThreadInfo->start_table_from + t;
+        int64_t  len = snprintf(prefix, cap, "%s",
+                                stbInfo->childTblName[tableSeq]);
+        if (partial) {
+            len += snprintf(prefix + len, cap - len, " (%s)",
+                            stbInfo->partialColNameBuf);
+        }
+        if (stbInfo->autoCreateTable) {
+            len += snprintf(prefix + len, cap - len,
+                            " USING `%s` TAGS (%s) %s",
+                            stbInfo->stbName,
+                            getTagData(stbInfo, tableSeq), ttl);
+        }
+        len += snprintf(prefix + len, cap - len, " VALUES ");
+        pThreadInfo->sqlPrefix[t] = benchArenaStrndup(
+                pThreadInfo->sqlPrefixArena, prefix, len);
+        pThreadInfo->sqlPrefixLen[t] = (uint32_t)len;
+    }
+    tmfree(prefix);
+}
+
+static void freeInterlacePrefixes(threadInfo *pThreadInfo) {
+    tmfree(pThreadInfo->sqlPrefix);
+    tmfree(pThreadInfo->sqlPrefixLen);
+    benchArenaDestroy(pThreadInfo->sqlPrefixArena);
+    pThreadInfo->sqlPrefix = NULL;
+    pThreadInfo->sqlPrefixLen = NULL;
+    pThreadInfo->sqlPrefixArena = NULL;
+}
+
 static void *syncWriteInterlace(void *sarg) {
     threadInfo * pThreadInfo = (threadInfo *)sarg;
-    SDataBase *  database = pThreadInfo->dbInfo;
     SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    benchRandBind(&pThreadInfo->rand);
+    placeInsertThread(pThreadInfo);
     infoPrint(
               "thread[%d] start interlace inserting into table from "
               "%" PRIu64 " to %" PRIu64 "\n",
@@ -1051,13 +2036,16 @@ static void *syncWriteInterlace(void *sarg) {
     int64_t insertRows = stbInfo->insertRows;
     int32_t interlaceRows = stbInfo->interlaceRows;
     int64_t pos = 0;
-    uint32_t batchPerTblTimes = g_arguments->reqPerReq / interlaceRows;
+    uint32_t batchPerTblTimes;
     uint64_t   lastPrintTime = toolsGetTimestampMs();
-    int64_t   startTs = toolsGetTimestampUs();
+    int64_t   startTs = benchGetMonotonicUs();
     int64_t   endTs;
     uint64_t   tableSeq = pThreadInfo->start_table_from;
     int disorderRange = stbInfo->disorderRange;
     int64_t startTimestamp = stbInfo->startTimestamp;
+    if (TAOSC_IFACE == stbInfo->iface || REST_IFACE == stbInfo->iface) {
+        buildInterlacePrefixes(pThreadInfo);
+    }
 
     while (insertRows > 0) {
         int64_t tmp_total_insert_rows = 0;
@@ -1065,54 +2053,26 @@ static void *syncWriteInterlace(void *sarg) {
         if (insertRows <= interlaceRows) {
             interlaceRows = insertRows;
         }
+        batchPerTblTimes = max(insertBatchSize() / interlaceRows, 1);
+        if (SML_IFACE == stbInfo->iface || SML_REST_IFACE == stbInfo->iface) {
+            reserveSmlBuffers(pThreadInfo, batchPerTblTimes * interlaceRows);
+        }
         for (int i = 0; i < batchPerTblTimes; ++i) {
             if (g_arguments->terminate) {
                 goto free_of_interlace;
             }
             int64_t timestamp = pThreadInfo->start_time;
             char *  tableName = stbInfo->childTblName[tableSeq];
-            char ttl[20] = "";
-            if (stbInfo->ttl != 0) {
-                sprintf(ttl, "TTL %d", stbInfo->ttl);
-            }
             switch (stbInfo->iface) {
                 case REST_IFACE:
                 case TAOSC_IFACE: {
                     if (i == 0) {
                         ds_add_str(&pThreadInfo->buffer, STR_INSERT_INTO);
                     }
-                    if (stbInfo->partialColNum == stbInfo->cols->size) {
-                        if (stbInfo->autoCreateTable) {
-                            ds_add_strs(&pThreadInfo->buffer, 8,
-                                    tableName,
-                                    " USING `",
-                                    stbInfo->stbName,
-                                    "` TAGS (",
-                                    stbInfo->tagDataBuf + stbInfo->lenOfTags * tableSeq,
-                                    ") ", ttl, " VALUES ");
-                        } else {
-                            ds_add_strs(&pThreadInfo->buffer, 2,
-                                    tableName, " VALUES ");
-                        }
-                    } else {
-                        if (stbInfo->autoCreateTable) {
-                            ds_add_strs(&pThreadInfo->buffer, 10,
-                                        tableName,
-                                        " (",
-                                        stbInfo->partialColNameBuf,
-                                        ") USING `",
-                                        stbInfo->stbName,
-                                        "` TAGS (",
-                                        stbInfo->tagDataBuf + stbInfo->lenOfTags * tableSeq,
-                                        ") ", ttl, " VALUES ");
-                        } else {
-                            ds_add_strs(&pThreadInfo->buffer, 4,
-                                        tableName,
-                                        "(",
-                                        stbInfo->partialColNameBuf,
-                                        ") VALUES ");
-                        }
-                    }
+                    uint64_t t = tableSeq - pThreadInfo->start_table_from;
+                    ds_add_strn(&pThreadInfo->buffer,
+                                pThreadInfo->sqlPrefix[t],
+                                pThreadInfo->sqlPrefixLen[t]);
 
                     for (int64_t j = 0; j < interlaceRows; ++j) {
                         int64_t disorderTs = 0;
@@ -1131,12 +2091,14 @@ static void *syncWriteInterlace(void *sarg) {
                         }
                         char time_string[BIGINT_BUFF_LEN];
                         sprintf(time_string, "%"PRId64"", disorderTs?disorderTs:timestamp);
-                        ds_add_strs(&pThreadInfo->buffer, 5,
+                        int32_t rowLen;
+                        char *  row = getSampleRow(stbInfo, pos, &rowLen);
+                        ds_add_strs(&pThreadInfo->buffer, 3,
                                     "(",
                                     time_string,
-                                    ",",
-                                    stbInfo->sampleDataBuf + pos * stbInfo->lenOfCols,
-                                    ") ");
+                                    ",");
+                        ds_add_strn(&pThreadInfo->buffer, row, rowLen);
+                        ds_add_str(&pThreadInfo->buffer, ") ");
                         if (ds_len(pThreadInfo->buffer) > stbInfo->max_sql_len) {
                             errorPrint("sql buffer length (%"PRIu64") "
                                     "is larger than max sql length "
@@ -1147,7 +2109,7 @@ static void *syncWriteInterlace(void *sarg) {
                         }
                         generated++;
                         pos++;
-                        if (pos >= g_arguments->prepared_rand) {
+                        if (pos >= stbInfo->sampleRows) {
                             pos = 0;
                         }
                         timestamp += stbInfo->timestamp_step;
@@ -1155,7 +2117,14 @@ static void *syncWriteInterlace(void *sarg) {
                     break;
                 }
                 case STMT_IFACE: {
-                    if (taos_stmt_set_tbname(pThreadInfo->conn->stmt, tableName)) {
+                    if (stbInfo->stmtTagBind) {
+                        if (setStmtTbnameTags(pThreadInfo, tableSeq,
+                                              tableName)) {
+                            g_fail = true;
+                            goto free_of_interlace;
+                        }
+                    } else if (taos_stmt_set_tbname(pThreadInfo->conn->stmt,
+                                                    tableName)) {
                         errorPrint(
                             "taos_stmt_set_tbname(%s) failed, reason: %s\n",
                             tableName, taos_stmt_errstr(pThreadInfo->conn->stmt));
@@ -1168,6 +2137,10 @@ static void *syncWriteInterlace(void *sarg) {
                 }
                 case SML_REST_IFACE:
                 case SML_IFACE: {
+                    // valid until the next getTagData() of this thread
+                    char *tags = stbInfo->lineProtocol
+                        == TSDB_SML_JSON_PROTOCOL
+                        ? NULL : getTagData(stbInfo, tableSeq);
                     for (int64_t j = 0; j < interlaceRows; ++j) {
                         int64_t disorderTs = 0;
                         if (stbInfo->disorderRatio > 0) {
@@ -1186,48 +2159,20 @@ static void *syncWriteInterlace(void *sarg) {
                         }
 
                         if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                            tools_cJSON *tag = tools_cJSON_Duplicate(
-                                tools_cJSON_GetArrayItem(
-                                    pThreadInfo->sml_json_tags,
-                                    (int)tableSeq -
-                                        pThreadInfo->start_table_from),
-                                true);
-                            generateSmlJsonCols(
-                                pThreadInfo->json_array, tag, stbInfo,
-                                database->sml_precision,
-                                    disorderTs?disorderTs:timestamp);
-                        } else if (stbInfo->lineProtocol ==
-                                   TSDB_SML_LINE_PROTOCOL) {
-                            snprintf(
-                                pThreadInfo->lines[generated],
-                                stbInfo->lenOfCols + stbInfo->lenOfTags,
-                                "%s %s %" PRId64 "",
-                                pThreadInfo
-                                    ->sml_tags[(int)tableSeq -
-                                               pThreadInfo->start_table_from],
-                                stbInfo->sampleDataBuf +
-                                    pos * stbInfo->lenOfCols,
-                                disorderTs?disorderTs:timestamp);
+                            appendSmlJson(pThreadInfo, tableSeq,
+                                          disorderTs?disorderTs:timestamp);
                         } else {
-                            snprintf(
-                                pThreadInfo->lines[generated],
-                                stbInfo->lenOfCols + stbInfo->lenOfTags,
-                                "%s %" PRId64 " %s %s", stbInfo->stbName,
-                                disorderTs?disorderTs:timestamp,
-                                stbInfo->sampleDataBuf +
-                                    pos * stbInfo->lenOfCols,
-                                pThreadInfo
-                                    ->sml_tags[(int)tableSeq -
-                                               pThreadInfo->start_table_from]);
+                            int32_t colsLen;
+                            char *  cols = getSampleRow(stbInfo, pos,
+                                                        &colsLen);
+                            appendSmlLine(
+                                pThreadInfo, generated, tags,
+                                cols, colsLen,
+                                disorderTs?disorderTs:timestamp);
                         }
                         generated++;
                         timestamp += stbInfo->timestamp_step;
                     }
-                    if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                        pThreadInfo->lines[0] =
-                            tools_cJSON_PrintUnformatted(
-                                pThreadInfo->json_array);
-                    }
                     break;
                 }
             }
@@ -1251,61 +2196,54 @@ static void *syncWriteInterlace(void *sarg) {
             }
         }
 
-        startTs = toolsGetTimestampUs();
-        if (execInsert(pThreadInfo, generated)) {
-            g_fail = true;
-            goto free_of_interlace;
+        int64_t intendedTs = waitIntendedTs(pThreadInfo,
+                                            tmp_total_insert_rows);
+        uint64_t sqlLen = (TAOSC_IFACE == stbInfo->iface
+                           || REST_IFACE == stbInfo->iface)
+            ? ds_len(pThreadInfo->buffer) : 0;
+        if (pThreadInfo->pipe) {
+            if (submitPipelined(pThreadInfo, sqlLen,
+                                tmp_total_insert_rows, intendedTs)) {
+                g_fail = true;
+                goto free_of_interlace;
+            }
+        } else if (pThreadInfo->rest) {
+            if (submitRest(pThreadInfo, generated, sqlLen,
+                           tmp_total_insert_rows, intendedTs)) {
+                g_fail = true;
+                goto free_of_interlace;
+            }
+        } else {
+            startTs = benchGetMonotonicUs();
+            if (execInsert(pThreadInfo, generated, sqlLen)) {
+                g_fail = true;
+                goto free_of_interlace;
+            }
+            endTs = benchGetMonotonicUs();
+            recordInsertDelay(pThreadInfo, tmp_total_insert_rows,
+                              intendedTs, startTs, endTs);
         }
-        endTs = toolsGetTimestampUs();
 
-        pThreadInfo->totalInsertRows += tmp_total_insert_rows;
         switch (stbInfo->iface) {
             case TAOSC_IFACE:
             case REST_IFACE:
                 debugPrint("pThreadInfo->buffer: %s\n",
                            pThreadInfo->buffer);
-                free_ds(&pThreadInfo->buffer);
-                pThreadInfo->buffer = new_ds(0);
+                ds_clear(pThreadInfo->buffer);
                 break;
             case SML_REST_IFACE:
-                memset(pThreadInfo->buffer, 0,
-                       g_arguments->reqPerReq * (pThreadInfo->max_sql_len + 1));
             case SML_IFACE:
-                if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                    debugPrint("pThreadInfo->lines[0]: %s\n",
-                               pThreadInfo->lines[0]);
-                    tools_cJSON_Delete(pThreadInfo->json_array);
-                    pThreadInfo->json_array = tools_cJSON_CreateArray();
-                    tmfree(pThreadInfo->lines[0]);
-                } else {
-                    for (int j = 0; j < generated; ++j) {
-                        debugPrint("pThreadInfo->lines[%d]: %s\n", j,
-                                   pThreadInfo->lines[j]);
-                        memset(pThreadInfo->lines[j], 0,
-                               pThreadInfo->max_sql_len);
-                    }
-                }
+                debugPrint("pThreadInfo->buffer: %s\n",
+                           pThreadInfo->buffer);
+                pThreadInfo->lineLen = 0;
                 break;
             case STMT_IFACE:
                 break;
         }
 
-        int64_t delay = endTs - startTs;
-        if (delay <=0) {
-            debugPrint("thread[%d]: startTS: %"PRId64", endTS: %"PRId64"\n",
-                       pThreadInfo->threadID, startTs, endTs);
-        } else {
-            perfPrint("insert execution time is %10.2f ms\n",
-                      delay / 1E6);
-
-            int64_t * pdelay = benchCalloc(1, sizeof(int64_t), false);
-            *pdelay = delay;
-            benchArrayPush(pThreadInfo->delayList, pdelay);
-            pThreadInfo->totalDelay += delay;
-        }
-
         int64_t currentPrintTime = toolsGetTimestampMs();
-        if (currentPrintTime - lastPrintTime > 30 * 1000) {
+        if (!insertStatLive()
+                && currentPrintTime - lastPrintTime > 30 * 1000) {
             infoPrint(
                     "thread[%d] has currently inserted rows: %" PRIu64
                     "\n",
@@ -1314,6 +2252,13 @@ static void *syncWriteInterlace(void *sarg) {
         }
     }
 free_of_interlace:
+    if (pThreadInfo->pipe && waitPipelined(pThreadInfo)) {
+        g_fail = true;
+    }
+    if (pThreadInfo->rest && benchRestDrain(pThreadInfo->rest)) {
+        g_fail = true;
+    }
+    pThreadInfo->finishUs = benchGetMonotonicUs();
     if (0 == pThreadInfo->totalDelay) pThreadInfo->totalDelay = 1;
     succPrint(
             "thread[%d] %s(), completed total inserted rows: %" PRIu64
@@ -1323,13 +2268,74 @@ free_of_interlace:
             pThreadInfo->totalInsertRows,
             (double)(pThreadInfo->totalInsertRows /
             ((double)pThreadInfo->totalDelay / 1E6)));
+    freeInterlacePrefixes(pThreadInfo);
+    benchHttpRelease();
+    releaseTagData();
     return NULL;
 }
 
+// hand out the next table of a progressive thread. without a scheduler the
+// thread walks its static range; with one it claims chunks from its own
+// queue first and then steals from the queues of the other threads
+static bool nextTableSeq(threadInfo *pThreadInfo,
+                         uint64_t *tableSeq, char ***tableNames) {
+    if (pThreadInfo->claimNext < pThreadInfo->claimEnd) {
+        *tableSeq = pThreadInfo->claimNext++;
+        *tableNames = pThreadInfo->claimNames;
+        return true;
+    }
+
+    SBenchTableSched *sched = pThreadInfo->sched;
+    if (NULL == sched) {
+        if (pThreadInfo->claimNames) {
+            return false;
+        }
+#ifdef TD_VER_COMPATIBLE_3_0_0_0
+        if (g_arguments->nthreads_auto) {
+            pThreadInfo->claimNames = pThreadInfo->vg->childTblName;
+        } else {
+            pThreadInfo->claimNames = pThreadInfo->stbInfo->childTblName;
+        }
+#else
+        pThreadInfo->claimNames = pThreadInfo->stbInfo->childTblName;
+#endif
+        pThreadInfo->claimNext = pThreadInfo->start_table_from;
+        pThreadInfo->claimEnd = pThreadInfo->end_table_to + 1;
+        return nextTableSeq(pThreadInfo, tableSeq, tableNames);
+    }
+
+    for (int32_t n = 0; n < sched->size; n++) {
+        SBenchTableQueue *queue =
+            sched->queues + (pThreadInfo->threadID + n) % sched->size;
+        if (atomic_add_fetch_64(&queue->cursor, 0) >= queue->end) {
+            continue;
+        }
+        int64_t from = atomic_add_fetch_64(&queue->cursor, sched->chunk)
+            - sched->chunk;
+        if (from >= queue->end) {
+            continue;
+        }
+        int64_t end = from + sched->chunk;
+        if (end > queue->end) {
+            end = queue->end;
+        }
+        if (n > 0) {
+            pThreadInfo->tablesStolen += end - from;
+        }
+        pThreadInfo->claimNames = queue->names;
+        pThreadInfo->claimNext = from;
+        pThreadInfo->claimEnd = end;
+        return nextTableSeq(pThreadInfo, tableSeq, tableNames);
+    }
+    return false;
+}
+
 void *syncWriteProgressive(void *sarg) {
     threadInfo * pThreadInfo = (threadInfo *)sarg;
     SDataBase *  database = pThreadInfo->dbInfo;
     SSuperTable *stbInfo = pThreadInfo->stbInfo;
+    benchRandBind(&pThreadInfo->rand);
+    placeInsertThread(pThreadInfo);
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
     if (g_arguments->nthreads_auto) {
         if (0 == pThreadInfo->vg->tbCountPerVgId) {
@@ -1350,30 +2356,22 @@ void *syncWriteProgressive(void *sarg) {
             pThreadInfo->end_table_to + 1);
 #endif
     uint64_t   lastPrintTime = toolsGetTimestampMs();
-    int64_t   startTs = toolsGetTimestampUs();
+    int64_t   startTs = benchGetMonotonicUs();
     int64_t   endTs;
 
     int disorderRange = stbInfo->disorderRange;
     int64_t startTimestamp = stbInfo->startTimestamp;
     char *  pstr = pThreadInfo->buffer;
-    for (uint64_t tableSeq = pThreadInfo->start_table_from;
-         tableSeq <= pThreadInfo->end_table_to; tableSeq++) {
-
-        char *   tableName = NULL;
-
-#ifdef TD_VER_COMPATIBLE_3_0_0_0
-        if (g_arguments->nthreads_auto) {
-            tableName = pThreadInfo->vg->childTblName[tableSeq];
-        } else {
-            tableName = stbInfo->childTblName[tableSeq];
-        }
-#else
-        tableName = stbInfo->childTblName[tableSeq];
-#endif
+    uint64_t tableSeq;
+    char **  tableNames;
+    while (nextTableSeq(pThreadInfo, &tableSeq, &tableNames)) {
+        char *   tableName = tableNames[tableSeq];
         int64_t  timestamp = pThreadInfo->start_time;
         uint64_t len = 0;
-        int32_t pos = 0;
-        if (stbInfo->iface == STMT_IFACE && stbInfo->autoCreateTable) {
+        int64_t pos = 0;
+        // tags that cannot be bound need a statement per table
+        if (stbInfo->iface == STMT_IFACE && stbInfo->autoCreateTable
+                && !stbInfo->stmtTagBind) {
             taos_stmt_close(pThreadInfo->conn->stmt);
             pThreadInfo->conn->stmt = taos_stmt_init(pThreadInfo->conn->taos);
             if (NULL == pThreadInfo->conn->stmt) {
@@ -1398,6 +2396,11 @@ void *syncWriteProgressive(void *sarg) {
                 goto free_of_progressive;
             }
             uint32_t generated = 0;
+            uint32_t batch = insertBatchSize();
+            if (SML_IFACE == stbInfo->iface
+                    || SML_REST_IFACE == stbInfo->iface) {
+                reserveSmlBuffers(pThreadInfo, batch);
+            }
             switch (stbInfo->iface) {
                 case TAOSC_IFACE:
                 case REST_IFACE: {
@@ -1409,8 +2412,7 @@ void *syncWriteProgressive(void *sarg) {
                                         STR_INSERT_INTO, database->dbName,
                                         tableName, database->dbName,
                                         stbInfo->stbName,
-                                        stbInfo->tagDataBuf +
-                                        stbInfo->lenOfTags * tableSeq, ttl);
+                                        getTagData(stbInfo, tableSeq), ttl);
                         } else {
                             len = snprintf(pstr, MAX_SQL_LEN,
                                     "%s %s.%s VALUES ", STR_INSERT_INTO,
@@ -1424,8 +2426,7 @@ void *syncWriteProgressive(void *sarg) {
                                     STR_INSERT_INTO, database->dbName, tableName,
                                     stbInfo->partialColNameBuf,
                                     database->dbName, stbInfo->stbName,
-                                    stbInfo->tagDataBuf +
-                                    stbInfo->lenOfTags * tableSeq, ttl);
+                                    getTagData(stbInfo, tableSeq), ttl);
                         } else {
                             len = snprintf(pstr, MAX_SQL_LEN,
                                     "%s %s.%s (%s) VALUES ",
@@ -1435,14 +2436,15 @@ void *syncWriteProgressive(void *sarg) {
                         }
                     }
 
-                    for (int j = 0; j < g_arguments->reqPerReq; ++j) {
+                    for (int j = 0; j < batch; ++j) {
+                        int32_t rowLen;
+                        char *  row = getSampleRow(stbInfo, pos, &rowLen);
                         if (stbInfo->useSampleTs &&
                                 !stbInfo->random_data_source) {
                             len +=
                                 snprintf(pstr + len,
-                                        MAX_SQL_LEN - len, "(%s)",
-                                        stbInfo->sampleDataBuf +
-                                        pos * stbInfo->lenOfCols);
+                                        MAX_SQL_LEN - len, "(%.*s)",
+                                        rowLen, row);
                         } else {
                             int64_t disorderTs = 0;
                             if (stbInfo->disorderRatio > 0) {
@@ -1460,28 +2462,36 @@ void *syncWriteProgressive(void *sarg) {
                             }
                             len += snprintf(pstr + len,
                                 MAX_SQL_LEN - len,
-                                "(%" PRId64 ",%s)",
+                                "(%" PRId64 ",%.*s)",
                                             disorderTs?disorderTs:timestamp,
-                                stbInfo->sampleDataBuf +
-                                            pos * stbInfo->lenOfCols);
+                                rowLen, row);
                         }
                         pos++;
-                        if (pos >= g_arguments->prepared_rand) {
+                        if (pos >= stbInfo->sampleRows) {
                             pos = 0;
                         }
                         timestamp += stbInfo->timestamp_step;
                         generated++;
-                        if (len > (MAX_SQL_LEN - stbInfo->lenOfCols)) {
+                        if (i + generated >= stbInfo->insertRows) {
                             break;
                         }
-                        if (i + generated >= stbInfo->insertRows) {
+                        if (len > (MAX_SQL_LEN - stbInfo->lenOfCols)) {
+                            if (generated < batch) {
+                                warnSqlLenCap(generated, batch);
+                            }
                             break;
                         }
                     }
                     break;
                 }
                 case STMT_IFACE: {
-                    if (taos_stmt_set_tbname(pThreadInfo->conn->stmt,
+                    if (stbInfo->stmtTagBind) {
+                        if (setStmtTbnameTags(pThreadInfo, tableSeq,
+                                              tableName)) {
+                            g_fail = true;
+                            goto free_of_progressive;
+                        }
+                    } else if (taos_stmt_set_tbname(pThreadInfo->conn->stmt,
                                 tableName)) {
                         errorPrint(
                                 "taos_stmt_set_tbname(%s) failed,"
@@ -1492,52 +2502,31 @@ void *syncWriteProgressive(void *sarg) {
                     }
                     generated = bindParamBatch(
                         pThreadInfo,
-                        (g_arguments->reqPerReq > (stbInfo->insertRows - i))
+                        (batch > (stbInfo->insertRows - i))
                             ? (stbInfo->insertRows - i)
-                            : g_arguments->reqPerReq,
+                            : batch,
                         timestamp);
                     timestamp += generated * stbInfo->timestamp_step;
                     break;
                 }
                 case SML_REST_IFACE:
                 case SML_IFACE: {
-                    for (int j = 0; j < g_arguments->reqPerReq; ++j) {
+                    // valid until the next getTagData() of this thread
+                    char *tags = stbInfo->lineProtocol
+                        == TSDB_SML_JSON_PROTOCOL
+                        ? NULL : getTagData(stbInfo, tableSeq);
+                    for (int j = 0; j < batch; ++j) {
                         if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                            tools_cJSON *tag = tools_cJSON_Duplicate(
-                                tools_cJSON_GetArrayItem(
-                                    pThreadInfo->sml_json_tags,
-                                    (int)tableSeq -
-                                        pThreadInfo->start_table_from),
-                                true);
-                            generateSmlJsonCols(
-                                pThreadInfo->json_array, tag, stbInfo,
-                                database->sml_precision, timestamp);
-                        } else if (stbInfo->lineProtocol ==
-                                   TSDB_SML_LINE_PROTOCOL) {
-                            snprintf(
-                                pThreadInfo->lines[j],
-                                stbInfo->lenOfCols + stbInfo->lenOfTags,
-                                "%s %s %" PRId64 "",
-                                pThreadInfo
-                                    ->sml_tags[(int)tableSeq -
-                                               pThreadInfo->start_table_from],
-                                stbInfo->sampleDataBuf +
-                                    pos * stbInfo->lenOfCols,
-                                timestamp);
+                            appendSmlJson(pThreadInfo, tableSeq, timestamp);
                         } else {
-                            snprintf(
-                                pThreadInfo->lines[j],
-                                stbInfo->lenOfCols + stbInfo->lenOfTags,
-                                "%s %" PRId64 " %s %s", stbInfo->stbName,
-                                timestamp,
-                                stbInfo->sampleDataBuf +
-                                    pos * stbInfo->lenOfCols,
-                                pThreadInfo
-                                    ->sml_tags[(int)tableSeq -
-                                               pThreadInfo->start_table_from]);
+                            int32_t colsLen;
+                            char *  cols = getSampleRow(stbInfo, pos,
+                                                        &colsLen);
+                            appendSmlLine(pThreadInfo, j, tags,
+                                          cols, colsLen, timestamp);
                         }
                         pos++;
-                        if (pos >= g_arguments->prepared_rand) {
+                        if (pos >= stbInfo->sampleRows) {
                             pos = 0;
                         }
                         timestamp += stbInfo->timestamp_step;
@@ -1558,11 +2547,6 @@ void *syncWriteProgressive(void *sarg) {
                             break;
                         }
                     }
-                    if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                        pThreadInfo->lines[0] =
-                            tools_cJSON_PrintUnformatted(
-                                pThreadInfo->json_array);
-                    }
                     break;
                 }
                 default:
@@ -1572,12 +2556,30 @@ void *syncWriteProgressive(void *sarg) {
                 i += generated;
             }
             // only measure insert
-            startTs = toolsGetTimestampUs();
-            if(execInsert(pThreadInfo, generated)) {
-                g_fail = true;
-                goto free_of_progressive;
+            int64_t intendedTs = waitIntendedTs(pThreadInfo, generated);
+            if (pThreadInfo->pipe) {
+                if (submitPipelined(pThreadInfo, len, generated,
+                                    intendedTs)) {
+                    g_fail = true;
+                    goto free_of_progressive;
+                }
+                pstr = pThreadInfo->buffer;
+            } else if (pThreadInfo->rest) {
+                if (submitRest(pThreadInfo, generated, len,
+                               generated, intendedTs)) {
+                    g_fail = true;
+                    goto free_of_progressive;
+                }
+            } else {
+                startTs = benchGetMonotonicUs();
+                if(execInsert(pThreadInfo, generated, len)) {
+                    g_fail = true;
+                    goto free_of_progressive;
+                }
+                endTs = benchGetMonotonicUs()+1;
+                recordInsertDelay(pThreadInfo, generated,
+                                  intendedTs, startTs, endTs);
             }
-            endTs = toolsGetTimestampUs()+1;
 
             if (stbInfo->insert_interval > 0) {
                 debugPrint("%s() LN%d, insert_interval: %"PRIu64"\n",
@@ -1587,51 +2589,24 @@ void *syncWriteProgressive(void *sarg) {
                 toolsMsleep((int32_t)stbInfo->insert_interval);
             }
 
-            pThreadInfo->totalInsertRows += generated;
-
             switch (stbInfo->iface) {
                 case REST_IFACE:
                 case TAOSC_IFACE:
-                    memset(pThreadInfo->buffer, 0, pThreadInfo->max_sql_len);
+                    // every batch rewrites the buffer from offset 0
                     break;
                 case SML_REST_IFACE:
-                    memset(pThreadInfo->buffer, 0,
-                           g_arguments->reqPerReq *
-                               (pThreadInfo->max_sql_len + 1));
                 case SML_IFACE:
-                    if (stbInfo->lineProtocol == TSDB_SML_JSON_PROTOCOL) {
-                        tools_cJSON_Delete(pThreadInfo->json_array);
-                        pThreadInfo->json_array = tools_cJSON_CreateArray();
-                        tmfree(pThreadInfo->lines[0]);
-                    } else {
-                        for (int j = 0; j < generated; ++j) {
-                            debugPrint("pThreadInfo->lines[%d]: %s\n",
-                                       j, pThreadInfo->lines[j]);
-                            memset(pThreadInfo->lines[j], 0,
-                                   pThreadInfo->max_sql_len);
-                        }
-                    }
+                    debugPrint("pThreadInfo->buffer: %s\n",
+                               pThreadInfo->buffer);
+                    pThreadInfo->lineLen = 0;
                     break;
                 case STMT_IFACE:
                     break;
             }
 
-            int64_t delay = endTs - startTs;
-            if (delay <= 0) {
-                debugPrint("thread[%d]: startTs: %"PRId64", endTs: %"PRId64"\n",
-                        pThreadInfo->threadID, startTs, endTs);
-            } else {
-                perfPrint("insert execution time is %.6f s\n",
-                              delay / 1E6);
-
-                int64_t * pDelay = benchCalloc(1, sizeof(int64_t), false);
-                *pDelay = delay;
-                benchArrayPush(pThreadInfo->delayList, pDelay);
-                pThreadInfo->totalDelay += delay;
-            }
-
             int64_t currentPrintTime = toolsGetTimestampMs();
-            if (currentPrintTime - lastPrintTime > 30 * 1000) {
+            if (!insertStatLive()
+                    && currentPrintTime - lastPrintTime > 30 * 1000) {
                 infoPrint(
                         "thread[%d] has currently inserted rows: "
                         "%" PRId64 "\n",
@@ -1644,6 +2619,13 @@ void *syncWriteProgressive(void *sarg) {
         }  // insertRows
     }      // tableSeq
 free_of_progressive:
+    if (pThreadInfo->pipe && waitPipelined(pThreadInfo)) {
+        g_fail = true;
+    }
+    if (pThreadInfo->rest && benchRestDrain(pThreadInfo->rest)) {
+        g_fail = true;
+    }
+    pThreadInfo->finishUs = benchGetMonotonicUs();
     if (0 == pThreadInfo->totalDelay) pThreadInfo->totalDelay = 1;
     succPrint(
             "thread[%d] %s(), completed total inserted rows: %" PRIu64
@@ -1653,213 +2635,211 @@ free_of_progressive:
             pThreadInfo->totalInsertRows,
             (double)(pThreadInfo->totalInsertRows /
             ((double)pThreadInfo->totalDelay / 1E6)));
+    benchHttpRelease();
+    releaseTagData();
     return NULL;
 }
 
-static int parseBufferToStmtBatch(
-        SSuperTable* stbInfo)
-{
-    int32_t columnCount;
-    if (stbInfo) {
-        columnCount = stbInfo->cols->size;
-    } else {
-        SDataBase *db = benchArrayGet(g_arguments->databases, 0);
-        ASSERT(db);
-        stbInfo = benchArrayGet(db->superTbls, 0);
-        ASSERT(stbInfo);
-        columnCount = stbInfo->cols->size;
-    }
-
-    for (int c = 0; c < columnCount; c++) {
-        Field *col = benchArrayGet(stbInfo->cols, c);
-        char dataType = col->type;
-
-        char *tmpP = NULL;
-        char *is_null = NULL;
-
-        is_null = calloc(1, sizeof(char) *g_arguments->prepared_rand);
-        ASSERT(is_null);
-        col->is_null = is_null;
-
-        switch(dataType) {
-            case TSDB_DATA_TYPE_INT:
-            case TSDB_DATA_TYPE_UINT:
-                tmpP = calloc(1, sizeof(int) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_TINYINT:
-            case TSDB_DATA_TYPE_UTINYINT:
-                tmpP = calloc(1, sizeof(int8_t) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_SMALLINT:
-            case TSDB_DATA_TYPE_USMALLINT:
-                tmpP = calloc(1, sizeof(int16_t) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_BIGINT:
-            case TSDB_DATA_TYPE_UBIGINT:
-                tmpP = calloc(1, sizeof(int64_t) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_BOOL:
-                tmpP = calloc(1, sizeof(int8_t) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_FLOAT:
-                tmpP = calloc(1, sizeof(float) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_DOUBLE:
-                tmpP = calloc(1, sizeof(double) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_BINARY:
-            case TSDB_DATA_TYPE_NCHAR:
-                tmpP = calloc(1, g_arguments->prepared_rand * col->length);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            case TSDB_DATA_TYPE_TIMESTAMP:
-                tmpP = calloc(1, sizeof(int64_t) * g_arguments->prepared_rand);
-                assert(tmpP);
-                col->data = (void*)tmpP;
-                break;
-
-            default:
-                errorPrint("Unknown data type: %s\n",
-                        convertDatatypeToString(dataType));
-                exit(EXIT_FAILURE);
+#ifdef TD_VER_COMPATIBLE_3_0_0_0
+#define VGROUP_RESOLVE_BATCH 100000
+#define VGROUP_CACHE_MAGIC   "TDVGMAP1"
+
+typedef struct SVgroupCacheHead_S {
+    char     magic[8];
+    int64_t  ntables;
+    int32_t  vgroups;
+    uint64_t nameHash;
+} SVgroupCacheHead;
+
+// open addressing map from vgId to vgroup, sized to a power of two
+// at least twice the vgroup count so probes stay short
+static SVGroup **buildVgroupSlots(SDataBase *database, int32_t *mask) {
+    int32_t size = 16;
+    while (size < database->vgroups * 2) {
+        size <<= 1;
+    }
+    SVGroup **slots = benchCalloc(size, sizeof(SVGroup *), true);
+    for (int32_t v = 0; v < database->vgroups; v++) {
+        SVGroup *vg = benchArrayGet(database->vgArray, v);
+        uint32_t h = ((uint32_t)vg->vgId * 2654435761u) & (size - 1);
+        while (slots[h]) {
+            h = (h + 1) & (size - 1);
         }
+        slots[h] = vg;
     }
+    *mask = size - 1;
+    return slots;
+}
 
-    char *sampleDataBuf = stbInfo->sampleDataBuf;
-    int64_t lenOfOneRow = stbInfo->lenOfCols;
-
-    if (stbInfo->useSampleTs) {
-        columnCount += 1; // for skipping first column
+static SVGroup *findVgroup(SVGroup **slots, int32_t mask, int32_t vgId) {
+    uint32_t h = ((uint32_t)vgId * 2654435761u) & mask;
+    while (slots[h]) {
+        if (slots[h]->vgId == vgId) {
+            return slots[h];
+        }
+        h = (h + 1) & mask;
     }
-    for (int i=0; i < g_arguments->prepared_rand; i++) {
-        int cursor = 0;
-
-        for (int c = 0; c < columnCount; c++) {
-            char *restStr = sampleDataBuf
-                + lenOfOneRow * i + cursor;
-            int lengthOfRest = strlen(restStr);
-
-            int index = 0;
-            for (index = 0; index < lengthOfRest; index ++) {
-                if (restStr[index] == ',') {
-                    break;
-                }
-            }
+    return NULL;
+}
 
-            cursor += index + 1; // skip ',' too
-            if ((0 == c) && stbInfo->useSampleTs) {
-                continue;
-            }
+static uint64_t hashTableNames(SSuperTable *stbInfo, int64_t ntables) {
+    uint64_t h = 14695981039346656037ULL;
+    for (int64_t i = 0; i < ntables; i++) {
+        for (const char *p = stbInfo->childTblName[i]; *p; p++) {
+            h = (h ^ (uint8_t)*p) * 1099511628211ULL;
+        }
+        h = (h ^ '\n') * 1099511628211ULL;
+    }
+    return h;
+}
 
-            char *tmpStr = calloc(1, index + 1);
-            if (NULL == tmpStr) {
-                errorPrint("%s() LN%d, Failed to allocate %d bind buffer\n",
-                        __func__, __LINE__, index + 1);
-                return -1;
-            }
-            Field *col = benchArrayGet(stbInfo->cols,
-                    (stbInfo->useSampleTs?c-1:c));
-            char dataType = col->type;
+static void getVgroupCachePath(SDataBase *database, SSuperTable *stbInfo,
+                               char *path) {
+    snprintf(path, MAX_PATH_LEN, "%s/%s.%s.vgroups",
+             g_arguments->vgroup_cache, database->dbName, stbInfo->stbName);
+}
 
-            strncpy(tmpStr, restStr, index);
+// returns 0 if every table got its vgId from a cache file that matches
+// the current table names and vgroups, -1 if they must be resolved
+static int loadVgroupCache(SDataBase *database, SSuperTable *stbInfo,
+                           int64_t ntables, int32_t *vgIds,
+                           SVGroup **slots, int32_t mask) {
+    if (NULL == g_arguments->vgroup_cache) {
+        return -1;
+    }
+    char path[MAX_PATH_LEN];
+    getVgroupCachePath(database, stbInfo, path);
+    FILE *fp = fopen(path, "rb");
+    if (NULL == fp) {
+        return -1;
+    }
 
-            if (0 == strcmp(tmpStr, "NULL")) {
-                *(col->is_null + i) = true;
-            } else {
-                switch(dataType) {
-                    case TSDB_DATA_TYPE_INT:
-                    case TSDB_DATA_TYPE_UINT:
-                        *((int32_t*)col->data + i) = atoi(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_FLOAT:
-                        *((float*)col->data +i) = (float)atof(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_DOUBLE:
-                        *((double*)col->data + i) = atof(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_TINYINT:
-                    case TSDB_DATA_TYPE_UTINYINT:
-                        *((int8_t*)col->data + i) = (int8_t)atoi(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_SMALLINT:
-                    case TSDB_DATA_TYPE_USMALLINT:
-                        *((int16_t*) col->data + i) = (int16_t)atoi(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_BIGINT:
-                    case TSDB_DATA_TYPE_UBIGINT:
-                        *((int64_t*)col->data + i) = (int64_t)atol(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_BOOL:
-                        *((int8_t*)col->data + i) = (int8_t)atoi(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_TIMESTAMP:
-                        *((int64_t*)col->data + i) = (int64_t)atol(tmpStr);
-                        break;
-
-                    case TSDB_DATA_TYPE_BINARY:
-                    case TSDB_DATA_TYPE_NCHAR:
-                        {
-                            size_t tmpLen = strlen(tmpStr);
-                            debugPrint("%s() LN%d, index: %d, "
-                                    "tmpStr len: %"PRIu64", col->length: %d\n",
-                                    __func__, __LINE__,
-                                    i, (uint64_t)tmpLen, col->length);
-                            if (tmpLen-2 > col->length) {
-                                errorPrint("data length %"PRIu64" "
-                                        "is larger than column length %d\n",
-                                        (uint64_t)tmpLen, col->length);
-                            }
+    int code = -1;
+    SVgroupCacheHead head;
+    if (1 != fread(&head, sizeof(head), 1, fp)
+            || memcmp(head.magic, VGROUP_CACHE_MAGIC, sizeof(head.magic))
+            || head.ntables != ntables
+            || head.vgroups != database->vgroups
+            || head.nameHash != hashTableNames(stbInfo, ntables)
+            || ntables != fread(vgIds, sizeof(int32_t), ntables, fp)) {
+        goto end_of_load;
+    }
+    for (int64_t i = 0; i < ntables; i++) {
+        if (NULL == findVgroup(slots, mask, vgIds[i])) {
+            goto end_of_load;
+        }
+    }
+    infoPrint("loaded vgroups of %" PRId64 " tables from %s\n",
+              ntables, path);
+    code = 0;
 
-                            if (tmpLen > 2) {
-                                strncpy((char *)col->data + i * col->length,
-                                        tmpStr+1, min(col->length, tmpLen - 2));
-                            } else {
-                                strcpy((char *)col->data + i * col->length, "");
-                            }
-                        }
-                        break;
+end_of_load:
+    if (code) {
+        infoPrint("vgroup cache %s is stale, will resolve again\n", path);
+    }
+    fclose(fp);
+    return code;
+}
 
-                    default:
-                        break;
-                }
-            }
+static void saveVgroupCache(SDataBase *database, SSuperTable *stbInfo,
+                            int64_t ntables, int32_t *vgIds) {
+    if (NULL == g_arguments->vgroup_cache) {
+        return;
+    }
+    char path[MAX_PATH_LEN];
+    char tmpPath[MAX_PATH_LEN + 8];
+    getVgroupCachePath(database, stbInfo, path);
+    // write aside and rename over, a run killed halfway must not leave
+    // a truncated cache for the next one
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    FILE *fp = fopen(tmpPath, "wb");
+    if (NULL == fp) {
+        warnPrint("failed to open vgroup cache %s, reason: %s\n",
+                  tmpPath, strerror(errno));
+        return;
+    }
+
+    SVgroupCacheHead head = {0};
+    memcpy(head.magic, VGROUP_CACHE_MAGIC, sizeof(head.magic));
+    head.ntables = ntables;
+    head.vgroups = database->vgroups;
+    head.nameHash = hashTableNames(stbInfo, ntables);
+    if (1 != fwrite(&head, sizeof(head), 1, fp)
+            || ntables != fwrite(vgIds, sizeof(int32_t), ntables, fp)) {
+        warnPrint("failed to write vgroup cache %s\n", tmpPath);
+        fclose(fp);
+        remove(tmpPath);
+        return;
+    }
+    if (fclose(fp)) {
+        warnPrint("failed to write vgroup cache %s, reason: %s\n",
+                  tmpPath, strerror(errno));
+        remove(tmpPath);
+        return;
+    }
+#ifdef WINDOWS
+    // rename() does not replace an existing file on windows
+    remove(path);
+#endif
+    if (rename(tmpPath, path)) {
+        warnPrint("failed to save vgroup cache %s, reason: %s\n",
+                  path, strerror(errno));
+        remove(tmpPath);
+    }
+}
 
-            free(tmpStr);
+// resolve vgIds of tables [from, from + ntables) in bulk, one catalog
+// request per batch instead of one per table
+static int resolveTableVgIds(SDataBase *database, SSuperTable *stbInfo,
+                             int64_t from, int64_t ntables,
+                             int32_t *vgIds) {
+    SBenchConn* conn = init_bench_conn();
+    if (NULL == conn) {
+        return -1;
+    }
+    int64_t start = toolsGetTimestampMs();
+    for (int64_t i = from; i < from + ntables; i += VGROUP_RESOLVE_BATCH) {
+        int32_t num = (from + ntables - i) > VGROUP_RESOLVE_BATCH
+            ? VGROUP_RESOLVE_BATCH : (int32_t)(from + ntables - i);
+        int ret = taos_get_tables_vgId(
+                conn->taos, database->dbName,
+                (const char **)(stbInfo->childTblName + i), num, vgIds + i);
+        if (ret) {
+            errorPrint("Failed to get %s db's vgId of tables from %s, "
+                       "reason: %s\n", database->dbName,
+                       stbInfo->childTblName[i], taos_errstr(NULL));
+            close_bench_conn(conn);
+            return -1;
         }
     }
-
+    close_bench_conn(conn);
+    infoPrint("resolved vgroups of %" PRId64 " tables in %.3f seconds\n",
+              ntables, (toolsGetTimestampMs() - start) / 1E3);
     return 0;
 }
+#endif  // TD_VER_COMPATIBLE_3_0_0_0
+
+static void printInsertDelay(SBenchHist *hist) {
+    succPrint("insert delay, "
+              "min: %.4fms, "
+              "avg: %.4fms, "
+              "p50: %.4fms, "
+              "p90: %.4fms, "
+              "p95: %.4fms, "
+              "p99: %.4fms, "
+              "p99.9: %.4fms, "
+              "p99.99: %.4fms, "
+              "max: %.4fms\n",
+              hist->min/1E3,
+              benchHistMean(hist)/1E3,
+              benchHistPercentile(hist, 50)/1E3,
+              benchHistPercentile(hist, 90)/1E3,
+              benchHistPercentile(hist, 95)/1E3,
+              benchHistPercentile(hist, 99)/1E3,
+              benchHistPercentile(hist, 99.9)/1E3,
+              benchHistPercentile(hist, 99.99)/1E3,
+              hist->max/1E3);
+}
 
 static int startMultiThreadInsertData(SDataBase* database,
         SSuperTable* stbInfo) {
@@ -1896,21 +2876,62 @@ static int startMultiThreadInsertData(SDataBase* database,
         g_arguments->reqPerReq = stbInfo->insertRows;
     }
 
+    stbInfo->stmtTagBind = stbInfo->iface == STMT_IFACE
+        && stbInfo->autoCreateTable && stmtTagsBindable(stbInfo);
     if (stbInfo->interlaceRows > 0 && stbInfo->iface == STMT_IFACE
-            && stbInfo->autoCreateTable) {
+            && stbInfo->autoCreateTable && !stbInfo->stmtTagBind) {
         infoPrint("%s",
-                "not support autocreate table with interlace row in stmt "
-                "insertion, will change to progressive mode\n");
+                "not support autocreate table with json tag and interlace "
+                "row in stmt insertion, will change to progressive mode\n");
         stbInfo->interlaceRows = 0;
     }
 
+    bool pipelined = false;
+    if (g_arguments->pipeline) {
+        if (stbInfo->iface != TAOSC_IFACE
+#ifdef WEBSOCKET
+                || g_arguments->websocket
+#endif
+                ) {
+            warnPrint("%s", "pipeline only works with taosc interface, "
+                      "will insert synchronously\n");
+        } else {
+            pipelined = true;
+        }
+    }
+
+    bool restEngine = false;
+    if (g_arguments->rest_connections > 0) {
+        if ((stbInfo->iface != REST_IFACE && stbInfo->iface != SML_REST_IFACE)
+                || (stbInfo->lineProtocol == TSDB_SML_TELNET_PROTOCOL
+                    && stbInfo->tcpTransfer)) {
+            warnPrint("%s", "rest_connections only works with rest and "
+                      "sml-rest interfaces, will insert synchronously\n");
+        } else {
+            restEngine = true;
+        }
+    }
+
+    if (g_arguments->target_rate > 0) {
+        if (stbInfo->insert_interval > 0) {
+            warnPrint("insert_interval(%" PRIu64 ") is ignored when "
+                      "target rate is set\n", stbInfo->insert_interval);
+            stbInfo->insert_interval = 0;
+        }
+        infoPrint("target rate: %.2f %s/second %s, latency is measured "
+                  "from the scheduled send time\n",
+                  g_arguments->target_rate,
+                  g_arguments->rate_by_requests ? "requests" : "rows",
+                  g_arguments->rate_per_thread ? "per thread" : "in total");
+    }
+
     uint64_t tableFrom = 0;
     uint64_t ntables = stbInfo->childTblCount;
     stbInfo->childTblName = benchCalloc(stbInfo->childTblCount,
             sizeof(char *), true);
-    for (int64_t i = 0; i < stbInfo->childTblCount; ++i) {
-        stbInfo->childTblName[i] = benchCalloc(1, TSDB_TABLE_NAME_LEN, true);
-    }
+    // names are packed back to back instead of one allocation each
+    stbInfo->childTblNameArena = benchArenaInit(BENCH_ARENA_CHUNK_SIZE);
+    char name[TSDB_TABLE_NAME_LEN];
 
     if ((stbInfo->iface != SML_IFACE && stbInfo->iface != SML_REST_IFACE)
             && stbInfo->childTblExists) {
@@ -1944,10 +2965,13 @@ static int startMultiThreadInsertData(SDataBase* database,
         TAOS_ROW row = NULL;
         while ((row = taos_fetch_row(res)) != NULL) {
             int *lengths = taos_fetch_lengths(res);
-            stbInfo->childTblName[count][0] = '`';
-            strncpy(stbInfo->childTblName[count] + 1, row[0], lengths[0]);
-            stbInfo->childTblName[count][lengths[0] + 1] = '`';
-            stbInfo->childTblName[count][lengths[0] + 2] = '\0';
+            char *tbName = benchArenaAlloc(stbInfo->childTblNameArena,
+                                           lengths[0] + 3);
+            tbName[0] = '`';
+            memcpy(tbName + 1, row[0], lengths[0]);
+            tbName[lengths[0] + 1] = '`';
+            tbName[lengths[0] + 2] = '\0';
+            stbInfo->childTblName[count] = tbName;
             debugPrint("stbInfo->childTblName[%" PRId64 "]: %s\n",
                        count, stbInfo->childTblName[count]);
             count++;
@@ -1956,57 +2980,92 @@ static int startMultiThreadInsertData(SDataBase* database,
         taos_free_result(res);
         close_bench_conn(conn);
     } else if (stbInfo->childTblCount == 1 && stbInfo->tags->size == 0) {
+        int n;
         if (stbInfo->escape_character) {
-            snprintf(stbInfo->childTblName[0], TSDB_TABLE_NAME_LEN,
-                    "`%s`", stbInfo->stbName);
+            n = snprintf(name, TSDB_TABLE_NAME_LEN, "`%s`", stbInfo->stbName);
         } else {
-            snprintf(stbInfo->childTblName[0], TSDB_TABLE_NAME_LEN,
-                    "%s", stbInfo->stbName);
+            n = snprintf(name, TSDB_TABLE_NAME_LEN, "%s", stbInfo->stbName);
         }
+        stbInfo->childTblName[0] = benchArenaStrndup(
+                stbInfo->childTblNameArena, name,
+                min(n, TSDB_TABLE_NAME_LEN - 1));
     } else {
         for (int64_t i = 0; i < stbInfo->childTblCount; ++i) {
+            int n;
             if (stbInfo->escape_character) {
-                snprintf(stbInfo->childTblName[i], TSDB_TABLE_NAME_LEN,
+                n = snprintf(name, TSDB_TABLE_NAME_LEN,
                         "`%s%" PRIu64 "`", stbInfo->childTblPrefix, i);
             } else {
-                snprintf(stbInfo->childTblName[i], TSDB_TABLE_NAME_LEN,
+                n = snprintf(name, TSDB_TABLE_NAME_LEN,
                         "%s%" PRIu64 "", stbInfo->childTblPrefix, i);
             }
+            stbInfo->childTblName[i] = benchArenaStrndup(
+                    stbInfo->childTblNameArena, name,
+                    min(n, TSDB_TABLE_NAME_LEN - 1));
         }
         ntables = stbInfo->childTblCount;
     }
+    debugPrint("%" PRIu64 " bytes of child table names of stable %s\n",
+               stbInfo->childTblNameArena->bytes, stbInfo->stbName);
     if (ntables == 0) {
         return 0;
     }
 
+    // a worker process only inserts into its own slice of the tables
+    uint64_t allTables = ntables;
+    if (g_procStat) {
+        tableFrom = allTables * g_procIndex / g_procShm->count;
+        ntables = allTables * (g_procIndex + 1) / g_procShm->count
+            - tableFrom;
+        infoPrint("process[%d] inserts into %" PRIu64 " table(s) from %"
+                  PRIu64 " of stable %s\n", g_procIndex, ntables, tableFrom,
+                  stbInfo->stbName);
+        if (ntables == 0) {
+            return 0;
+        }
+    }
+
     int32_t threads = g_arguments->nthreads;
     int64_t a = 0, b = 0;
 
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
     if ((0 == stbInfo->interlaceRows)
             && (g_arguments->nthreads_auto)) {
-        SBenchConn* conn = init_bench_conn();
-        if (NULL == conn) {
-            return -1;
+        int32_t   slotMask = 0;
+        SVGroup **slots = buildVgroupSlots(database, &slotMask);
+        int32_t  *vgIds = benchCalloc(allTables, sizeof(int32_t), true);
+        if (loadVgroupCache(database, stbInfo, allTables, vgIds,
+                            slots, slotMask)) {
+            // a worker process only looks up its own slice, the cache
+            // is written by single process runs that resolved them all
+            if (resolveTableVgIds(database, stbInfo, tableFrom, ntables,
+                                  vgIds)) {
+                tmfree(slots);
+                tmfree(vgIds);
+                return -1;
+            }
+            if (NULL == g_procStat) {
+                saveVgroupCache(database, stbInfo, allTables, vgIds);
+            }
         }
 
-        for (int64_t i = 0; i < stbInfo->childTblCount; i++) {
-            int vgId;
-            int ret = taos_get_table_vgId(conn->taos, database->dbName,
-                                          stbInfo->childTblName[i], &vgId);
-            if (ret < 0) {
-                errorPrint("Failed to get %s db's %s table's vgId\n",
-                           database->dbName, stbInfo->childTblName[i]);
+        for (int32_t v = 0; v < database->vgroups; v++) {
+            SVGroup *vg = benchArrayGet(database->vgArray, v);
+            vg->tbCountPerVgId = 0;
+            tmfree(vg->childTblName);
+            vg->childTblName = NULL;
+        }
+        for (uint64_t i = tableFrom; i < tableFrom + ntables; i++) {
+            SVGroup *vg = findVgroup(slots, slotMask, vgIds[i]);
+            if (NULL == vg) {
+                errorPrint("table %s is on unknown vgroup %d of db %s\n",
+                           stbInfo->childTblName[i], vgIds[i],
+                           database->dbName);
+                tmfree(slots);
+                tmfree(vgIds);
                 return -1;
             }
-            debugPrint("Db %s\'s table\'s %s vgId is: %d\n",
-                       database->dbName, stbInfo->childTblName[i], vgId);
-            for (int32_t v = 0; v < database->vgroups; v ++) {
-                SVGroup *vg = benchArrayGet(database->vgArray, v);
-                if (vgId == vg->vgId) {
-                    vg->tbCountPerVgId ++;
-                }
-            }
+            vg->tbCountPerVgId ++;
         }
 
         threads = 0;
@@ -2014,6 +3073,7 @@ static int startMultiThreadInsertData(SDataBase* database,
             SVGroup *vg = benchArrayGet(database->vgArray, v);
             infoPrint("Total %"PRId64" tables on bb %s's vgroup %d (id: %d)\n",
                       vg->tbCountPerVgId, database->dbName, v, vg->vgId);
+            vg->tbOffset = 0;
             if (vg->tbCountPerVgId) {
                 threads ++;
             } else {
@@ -2021,31 +3081,14 @@ static int startMultiThreadInsertData(SDataBase* database,
             }
             vg->childTblName = benchCalloc(vg->tbCountPerVgId,
                                            sizeof(char *), true);
-            for (int64_t n = 0; n < vg->tbCountPerVgId; n++) {
-                vg->childTblName[n] = benchCalloc(1, TSDB_TABLE_NAME_LEN, true);
-                vg->tbOffset = 0;
-            }
-        }
-        for (int64_t i = 0; i < stbInfo->childTblCount; i++) {
-            int vgId;
-            int ret = taos_get_table_vgId(conn->taos, database->dbName,
-                                          stbInfo->childTblName[i], &vgId);
-            if (ret < 0) {
-                errorPrint("Failed to get %s db's %s table's vgId\n",
-                           database->dbName, stbInfo->childTblName[i]);
-                return -1;
-            }
-            debugPrint("Db %s\'s table\'s %s vgId is: %d\n",
-                       database->dbName, stbInfo->childTblName[i], vgId);
-            for (int32_t v = 0; v < database->vgroups; v ++) {
-                SVGroup *vg = benchArrayGet(database->vgArray, v);
-                if (vgId == vg->vgId) {
-                    strcpy(vg->childTblName[vg->tbOffset], stbInfo->childTblName[i]);
-                    vg->tbOffset ++;
-                }
-            }
         }
-        close_bench_conn(conn);
+        // the vgroup lists borrow the names owned by stbInfo
+        for (uint64_t i = tableFrom; i < tableFrom + ntables; i++) {
+            SVGroup *vg = findVgroup(slots, slotMask, vgIds[i]);
+            vg->childTblName[vg->tbOffset++] = stbInfo->childTblName[i];
+        }
+        tmfree(slots);
+        tmfree(vgIds);
     } else {
         a = ntables / threads;
         if (a < 1) {
@@ -2075,6 +3118,35 @@ static int startMultiThreadInsertData(SDataBase* database,
     pthread_t * pids = benchCalloc(1, threads * sizeof(pthread_t), true);
     threadInfo *infos = benchCalloc(1, threads * sizeof(threadInfo), true);
 
+    SBenchTableSched *sched = NULL;
+    if (g_arguments->dynamic_schedule) {
+        if (stbInfo->interlaceRows > 0
+                || stbInfo->iface == SML_IFACE
+                || stbInfo->iface == SML_REST_IFACE) {
+            warnPrint("%s", "dynamic table schedule only works with "
+                      "progressive taosc, rest or stmt insertion, "
+                      "will use static schedule\n");
+        } else {
+            sched = benchCalloc(1, sizeof(SBenchTableSched), true);
+            sched->queues = benchCalloc(threads, sizeof(SBenchTableQueue),
+                                        true);
+            sched->size = threads;
+            sched->chunk = g_arguments->schedule_chunk;
+            if (sched->chunk <= 0) {
+                // small enough to balance the tail, large enough to keep
+                // the shared cursors cold
+                sched->chunk = ntables / ((int64_t)threads * 16);
+                if (sched->chunk > 64) {
+                    sched->chunk = 64;
+                } else if (sched->chunk < 1) {
+                    sched->chunk = 1;
+                }
+            }
+            infoPrint("dynamic table schedule with chunk of %" PRId64
+                      " table(s)\n", sched->chunk);
+        }
+    }
+
     for (int32_t i = 0; i < threads; i++) {
         threadInfo *pThreadInfo = infos + i;
         pThreadInfo->threadID = i;
@@ -2083,6 +3155,10 @@ static int startMultiThreadInsertData(SDataBase* database,
         pThreadInfo->start_time = stbInfo->startTimestamp;
         pThreadInfo->totalInsertRows = 0;
         pThreadInfo->samplePos = 0;
+        // forked workers get streams of their own, above the 1 << 32,
+        // 2 << 32 and 3 << 32 ranges of the pool, tag and default streams
+        benchRandSeed(&pThreadInfo->rand, g_arguments->random_seed,
+                      ((uint64_t)max(g_procIndex, 0) << 40) + i + 1);
 #ifdef TD_VER_COMPATIBLE_3_0_0_0
         if ((0 == stbInfo->interlaceRows)
                 && (g_arguments->nthreads_auto)) {
@@ -2111,21 +3187,53 @@ static int startMultiThreadInsertData(SDataBase* database,
         pThreadInfo->end_table_to = i < b ? tableFrom + a : tableFrom + a - 1;
         tableFrom = pThreadInfo->end_table_to + 1;
 #endif  // TD_VER_COMPATIBLE_3_0_0_0
-        pThreadInfo->delayList = benchArrayInit(1, sizeof(int64_t));
+        if (sched) {
+            SBenchTableQueue *queue = sched->queues + i;
+#ifdef TD_VER_COMPATIBLE_3_0_0_0
+            if ((0 == stbInfo->interlaceRows)
+                    && (g_arguments->nthreads_auto)) {
+                queue->names = pThreadInfo->vg->childTblName;
+            } else {
+                queue->names = stbInfo->childTblName;
+            }
+#else
+            queue->names = stbInfo->childTblName;
+#endif
+            queue->cursor = pThreadInfo->start_table_from;
+            queue->end = pThreadInfo->end_table_to + 1;
+            pThreadInfo->sched = sched;
+        }
+        pThreadInfo->delayHist = benchHistInit();
+        if (g_arguments->target_rate > 0) {
+            double rate = g_arguments->target_rate;
+            if (!g_arguments->rate_per_thread && g_procStat) {
+                // worker processes split the total evenly
+                rate /= g_procShm->count;
+            }
+            pThreadInfo->rateUnitUs = 1E6 / rate;
+        }
+        if (insertStatLive()) {
+            pThreadInfo->statHist = benchHistInit();
+        }
         switch (stbInfo->iface) {
             case REST_IFACE: {
                 if (stbInfo->interlaceRows > 0) {
                     pThreadInfo->buffer = new_ds(0);
                 } else {
                     pThreadInfo->buffer = benchCalloc(1, MAX_SQL_LEN, true);
+                    pThreadInfo->bufferSize = MAX_SQL_LEN;
                 }
-                int sockfd = createSockFd();
-                if (sockfd < 0) {
-                    tmfree(pids);
-                    tmfree(infos);
-                    return -1;
+                // the rest engine opens connections of its own
+                pThreadInfo->sockfd = -1;
+                if (!restEngine) {
+                    int sockfd = createSockFd();
+                    if (sockfd < 0) {
+                        tmfree(pids);
+                        tmfree(infos);
+                        return -1;
+                    }
+                    pThreadInfo->sockfd = sockfd;
                 }
-                pThreadInfo->sockfd = sockfd;
                 break;
             }
             case STMT_IFACE: {
@@ -2144,38 +3252,36 @@ static int startMultiThreadInsertData(SDataBase* database,
                                taos_errstr(NULL));
                     return -1;
                 }
-                if (taos_select_db(pThreadInfo->conn->taos, database->dbName)) {
+                if (benchSelectDb(pThreadInfo->conn, database->dbName)) {
                     tmfree(pids);
                     tmfree(infos);
                     errorPrint("taos select database(%s) failed\n",
                             database->dbName);
                     return -1;
                 }
-                if (!stbInfo->autoCreateTable) {
+                if (!stbInfo->autoCreateTable || stbInfo->stmtTagBind) {
                     if (prepareStmt(stbInfo, pThreadInfo->conn->stmt, 0)) {
                         return -1;
                     }
                 }
 
-                pThreadInfo->bind_ts = benchCalloc(1, sizeof(int64_t), true);
-                pThreadInfo->bind_ts_array =
-                        benchCalloc(1, sizeof(int64_t) * g_arguments->reqPerReq, true);
-                pThreadInfo->bindParams = benchCalloc(
-                    1, sizeof(TAOS_MULTI_BIND) * (stbInfo->cols->size + 1), true);
-                pThreadInfo->is_null = benchCalloc(1, g_arguments->reqPerReq, true);
-                parseBufferToStmtBatch(stbInfo);
+                prepareStmtBind(pThreadInfo);
 
                 break;
             }
             case SML_REST_IFACE: {
-                int sockfd = createSockFd();
-                if (sockfd < 0) {
-                    free(pids);
-                    free(infos);
-                    return -1;
+                pThreadInfo->sockfd = -1;
+                if (!restEngine) {
+                    int sockfd = createSockFd();
+                    if (sockfd < 0) {
+                        free(pids);
+                        free(infos);
+                        return -1;
+                    }
+                    pThreadInfo->sockfd = sockfd;
                 }
-                pThreadInfo->sockfd = sockfd;
             }
+            /* FALLTHROUGH */
             case SML_IFACE: {
                 pThreadInfo->conn = init_bench_conn();
                 if (pThreadInfo->conn == NULL) {
@@ -2184,7 +3290,7 @@ static int startMultiThreadInsertData(SDataBase* database,
                     errorPrint("%s() init connection failed\n", __func__);
                     return -1;
                 }
-                if (taos_select_db(pThreadInfo->conn->taos, database->dbName)) {
+                if (benchSelectDb(pThreadInfo->conn, database->dbName)) {
                     tmfree(pids);
                     tmfree(infos);
                     errorPrint("taos select database(%s) failed\n", database->dbName);
@@ -2192,46 +3298,11 @@ static int startMultiThreadInsertData(SDataBase* database,
                 }
                 pThreadInfo->max_sql_len =
                     stbInfo->lenOfCols + stbInfo->lenOfTags;
-                if (stbInfo->iface == SML_REST_IFACE) {
-                    pThreadInfo->buffer =
-                            benchCalloc(1, g_arguments->reqPerReq *
-                                      (1 + pThreadInfo->max_sql_len), true);
-                }
-                if (stbInfo->lineProtocol != TSDB_SML_JSON_PROTOCOL) {
-                    pThreadInfo->sml_tags =
-                        (char **)benchCalloc(pThreadInfo->ntables, sizeof(char *), true);
-                    for (int t = 0; t < pThreadInfo->ntables; t++) {
-                        pThreadInfo->sml_tags[t] =
-                                benchCalloc(1, stbInfo->lenOfTags, true);
-                    }
-
-                    for (int t = 0; t < pThreadInfo->ntables; t++) {
-                        if (generateRandData(
-                                    stbInfo, pThreadInfo->sml_tags[t],
-                                    stbInfo->lenOfCols + stbInfo->lenOfTags,
-                                    stbInfo->tags, 1, true)) {
-                            return -1;
-                        }
-                        debugPrint("pThreadInfo->sml_tags[%d]: %s\n", t,
-                                   pThreadInfo->sml_tags[t]);
-                    }
-                    pThreadInfo->lines =
-                            benchCalloc(g_arguments->reqPerReq, sizeof(char *), true);
-
-                    for (int j = 0; j < g_arguments->reqPerReq; j++) {
-                        pThreadInfo->lines[j] =
-                                benchCalloc(1, pThreadInfo->max_sql_len, true);
-                    }
-                } else {
-                    pThreadInfo->json_array = tools_cJSON_CreateArray();
-                    pThreadInfo->sml_json_tags = tools_cJSON_CreateArray();
-                    for (int t = 0; t < pThreadInfo->ntables; t++) {
-                        generateSmlJsonTags(
-                                pThreadInfo->sml_json_tags, stbInfo,
-                                pThreadInfo->start_table_from, t);
-                    }
-                    pThreadInfo->lines = (char **)benchCalloc(1, sizeof(char *), true);
-                }
+                // tags are generated when a table is reached, one arena
+                // per thread
+                reserveSmlBuffers(pThreadInfo, g_arguments->reqPerReqAuto
+                        ? min(AUTO_REQ_PER_REQ_START, g_arguments->reqPerReq)
+                        : g_arguments->reqPerReq);
                 break;
             }
             case TAOSC_IFACE: {
@@ -2242,9 +3313,7 @@ static int startMultiThreadInsertData(SDataBase* database,
                     errorPrint("%s() failed to connect\n", __func__);
                     return -1;
                 }
-                char command[SQL_BUFF_LEN];
-                sprintf(command, "USE %s", database->dbName);
-                if (queryDbExec(pThreadInfo->conn, command)) {
+                if (benchSelectDb(pThreadInfo->conn, database->dbName)) {
                     tmfree(pids);
                     tmfree(infos);
                     errorPrint("taos select database(%s) failed\n", database->dbName);
@@ -2254,6 +3323,15 @@ static int startMultiThreadInsertData(SDataBase* database,
                     pThreadInfo->buffer = new_ds(0);
                 } else {
                     pThreadInfo->buffer = benchCalloc(1, MAX_SQL_LEN, true);
+                    pThreadInfo->bufferSize = MAX_SQL_LEN;
+                }
+                if (pipelined) {
+                    pThreadInfo->pipe =
+                        benchCalloc(1, sizeof(SBenchPipe), true);
+                    pThreadInfo->pipe->sql = stbInfo->interlaceRows > 0
+                        ? new_ds(0) : benchCalloc(1, MAX_SQL_LEN, true);
+                    pthread_mutex_init(&pThreadInfo->pipe->lock, NULL);
+                    pthread_cond_init(&pThreadInfo->pipe->cond, NULL);
                 }
 
                 break;
@@ -2262,12 +3340,37 @@ static int startMultiThreadInsertData(SDataBase* database,
                 break;
         }
 
+        if (restEngine) {
+            pThreadInfo->rest = benchRestInit(
+                    g_arguments->rest_connections, g_arguments->rest_depth,
+                    database->dbName, database->precision, stbInfo->iface,
+                    stbInfo->lineProtocol, g_arguments->port,
+                    stbInfo->keep_trying ? stbInfo->keep_trying
+                                         : g_arguments->keep_trying,
+                    stbInfo->trying_interval ? stbInfo->trying_interval
+                                             : g_arguments->trying_interval,
+                    restInsertDone, pThreadInfo);
+            if (NULL == pThreadInfo->rest) {
+                tmfree(pids);
+                tmfree(infos);
+                return -1;
+            }
+        }
     }
 
     infoPrint("Estimate memory usage: %.2fMB\n",
               (double)g_memoryUsage / 1048576);
     prompt(0);
 
+    SInsertReporter *reporter = NULL;
+    if (insertStatLive()) {
+        reporter = startInsertReporter(infos, threads);
+    }
+    waitInsertWorkersReady();
+    startReqTuner(stbInfo);
+    g_rateStartUs = benchGetMonotonicUs();
+    g_rateUnits = 0;
+
     for (int i = 0; i < threads; i++) {
         threadInfo *pThreadInfo = infos + i;
         if (stbInfo->interlaceRows > 0) {
@@ -2281,24 +3384,33 @@ static int startMultiThreadInsertData(SDataBase* database,
         }
     }
 
-    int64_t start = toolsGetTimestampUs();
+    int64_t start = benchGetMonotonicUs();
 
     for (int i = 0; i < threads; i++) {
         if (!g_arguments->terminate)
             pthread_join(pids[i], NULL);
     }
 
-    int64_t end = toolsGetTimestampUs()+1;
+    int64_t end = benchGetMonotonicUs()+1;
+    stopInsertReporter(reporter);
+    reportReqTuner(stbInfo);
 
-    BArray *  total_delay_list = benchArrayInit(1, sizeof(int64_t));
-    int64_t   totalDelay = 0;
+    SBenchHist *totalHist = benchHistInit();
     uint64_t  totalInsertRows = 0;
+    int64_t   totalRawBytes = 0;
+    int64_t   totalWireBytes = 0;
+    int64_t   maxIdle = 0;
+    int64_t   totalIdle = 0;
+    uint64_t  totalStolen = 0;
 
     for (int i = 0; i < threads; i++) {
         threadInfo *pThreadInfo = infos + i;
         switch (stbInfo->iface) {
             case REST_IFACE:
-                destroySockFd(pThreadInfo->sockfd);
+                if (pThreadInfo->sockfd >= 0) {
+                    destroySockFd(pThreadInfo->sockfd);
+                }
+                benchRestDestroy(pThreadInfo->rest);
                 if (stbInfo->interlaceRows > 0) {
                     free_ds(&pThreadInfo->buffer);
                 } else {
@@ -2306,31 +3418,24 @@ static int startMultiThreadInsertData(SDataBase* database,
                 }
                 break;
             case SML_REST_IFACE:
-                tmfree(pThreadInfo->buffer);
+                benchRestDestroy(pThreadInfo->rest);
+                /* FALLTHROUGH */
             case SML_IFACE:
-                if (stbInfo->lineProtocol != TSDB_SML_JSON_PROTOCOL) {
-                    for (int t = 0; t < pThreadInfo->ntables; t++) {
-                        tmfree(pThreadInfo->sml_tags[t]);
-                    }
-                    for (int j = 0; j < g_arguments->reqPerReq; j++) {
-                        tmfree(pThreadInfo->lines[j]);
-                    }
-                    tmfree(pThreadInfo->sml_tags);
-
-                } else {
-                    tools_cJSON_Delete(pThreadInfo->sml_json_tags);
-                    tools_cJSON_Delete(pThreadInfo->json_array);
-                }
+                tmfree(pThreadInfo->smlJsonTags);
+                tmfree(pThreadInfo->buffer);
                 close_bench_conn(pThreadInfo->conn);
                 tmfree(pThreadInfo->lines);
                 break;
             case STMT_IFACE:
-                taos_stmt_close(pThreadInfo->conn->stmt);
                 close_bench_conn(pThreadInfo->conn);
-                tmfree(pThreadInfo->bind_ts);
                 tmfree(pThreadInfo->bind_ts_array);
                 tmfree(pThreadInfo->bindParams);
-                tmfree(pThreadInfo->is_null);
+                tmfree(pThreadInfo->bind_lengths);
+                tmfree(pThreadInfo->tagBindParams);
+                tmfree(pThreadInfo->tagBindBuf);
+                tmfree(pThreadInfo->tagBindText);
+                tmfree(pThreadInfo->tagBindLengths);
+                tmfree(pThreadInfo->tagBindNull);
                 break;
             case TAOSC_IFACE:
                 if (stbInfo->interlaceRows > 0) {
@@ -2338,56 +3443,87 @@ static int startMultiThreadInsertData(SDataBase* database,
                 } else {
                     tmfree(pThreadInfo->buffer);
                 }
+                if (pThreadInfo->pipe) {
+                    if (stbInfo->interlaceRows > 0) {
+                        free_ds(&pThreadInfo->pipe->sql);
+                    } else {
+                        tmfree(pThreadInfo->pipe->sql);
+                    }
+                    pthread_mutex_destroy(&pThreadInfo->pipe->lock);
+                    pthread_cond_destroy(&pThreadInfo->pipe->cond);
+                    tmfree(pThreadInfo->pipe);
+                }
                 close_bench_conn(pThreadInfo->conn);
                 break;
             default:
                 break;
         }
+        int64_t idle = pThreadInfo->finishUs
+            ? end - pThreadInfo->finishUs : end - start;
+        if (idle < 0) {
+            idle = 0;
+        }
+        // per thread detail only matters when threads can steal work
+        if (sched) {
+            infoPrint("thread[%d] idle %.3f seconds (%.1f%%) at the end of "
+                      "run, stole %" PRIu64 " table(s)\n",
+                      pThreadInfo->threadID, idle / 1E6,
+                      (end > start) ? idle * 100.0 / (end - start) : 0,
+                      pThreadInfo->tablesStolen);
+        } else {
+            debugPrint("thread[%d] idle %.3f seconds at the end of run\n",
+                       pThreadInfo->threadID, idle / 1E6);
+        }
+        maxIdle = max(maxIdle, idle);
+        totalIdle += idle;
+        totalStolen += pThreadInfo->tablesStolen;
         totalInsertRows += pThreadInfo->totalInsertRows;
-        totalDelay += pThreadInfo->totalDelay;
-        benchArrayAddBatch(total_delay_list, pThreadInfo->delayList->pData,
-                pThreadInfo->delayList->size);
-        tmfree(pThreadInfo->delayList);
+        totalRawBytes += pThreadInfo->statBytes;
+        totalWireBytes += pThreadInfo->statWireBytes;
+        benchHistMerge(totalHist, pThreadInfo->delayHist);
+        benchHistDestroy(pThreadInfo->delayHist);
+        if (pThreadInfo->statHist) {
+            benchHistDestroy(pThreadInfo->statHist);
+        }
+    }
+
+    if (threads > 0) {
+        infoPrint("threads idle at the end of run: max %.3f seconds, "
+                  "average %.3f seconds, %" PRIu64 " table(s) stolen\n",
+                  maxIdle / 1E6, totalIdle / 1E6 / threads, totalStolen);
     }
-    qsort(total_delay_list->pData, total_delay_list->size,
-            total_delay_list->elemSize, compare);
 
     free(pids);
     free(infos);
+    if (sched) {
+        tmfree(sched->queues);
+        tmfree(sched);
+    }
 
     succPrint("Spent %.6f seconds to insert rows: %" PRIu64
               " with %d thread(s) into %s %.2f records/second\n",
               (end - start)/1E6, totalInsertRows, threads,
               database->dbName,
               (double)(totalInsertRows / ((end - start)/1E6)));
-    if (!total_delay_list->size) {
-        benchArrayDestroy(total_delay_list);
+    if (g_arguments->rest_codec != REST_CODEC_NONE && totalRawBytes > 0) {
+        succPrint("sent %" PRId64 " bytes compressed from %" PRId64
+                  " raw bytes with %s, ratio %.2f%%, %.2f MB/s on the wire\n",
+                  totalWireBytes, totalRawBytes, benchHttpEncoding(),
+                  totalWireBytes * 100.0 / totalRawBytes,
+                  totalWireBytes / 1048576.0 / ((end - start)/1E6));
+    }
+    if (!totalHist->count) {
+        benchHistDestroy(totalHist);
         return -1;
     }
 
-    succPrint("insert delay, "
-              "min: %.4fms, "
-              "avg: %.4fms, "
-              "p90: %.4fms, "
-              "p95: %.4fms, "
-              "p99: %.4fms, "
-              "max: %.4fms\n",
-              *(int64_t *)(benchArrayGet(total_delay_list, 0))/1E3,
-              (double)totalDelay/total_delay_list->size/1E3,
-              *(int64_t *)(benchArrayGet(total_delay_list,
-                                         (int32_t)(total_delay_list->size
-                                         * 0.9)))/1E3,
-              *(int64_t *)(benchArrayGet(total_delay_list,
-                                         (int32_t)(total_delay_list->size
-                                         * 0.95)))/1E3,
-              *(int64_t *)(benchArrayGet(total_delay_list,
-                                         (int32_t)(total_delay_list->size
-                                         * 0.99)))/1E3,
-              *(int64_t *)(benchArrayGet(total_delay_list,
-                                         (int32_t)(total_delay_list->size
-                                         - 1)))/1E3);
-
-    benchArrayDestroy(total_delay_list);
+    if (g_procStat) {
+        lockProcStat(g_procStat);
+        benchHistMerge(&g_procStat->total, totalHist);
+        pthread_mutex_unlock(&g_procStat->lock);
+    }
+    printInsertDelay(totalHist);
+    benchHistDestroy(totalHist);
     if (g_fail) {
         return -1;
     }
@@ -2438,7 +3574,7 @@ static void* create_tsmas(void* args) {
         return NULL;
     }
     int finished = 0;
-    if (taos_select_db(conn->taos, pThreadInfo->dbName)) {
+    if (benchSelectDb(conn, pThreadInfo->dbName)) {
         errorPrint("failed to use database (%s)\n", pThreadInfo->dbName);
         close_bench_conn(conn);
         return NULL;
@@ -2528,11 +3664,10 @@ END:
     return code;
 }
 
-int insertTestProcess() {
-
-    prompt(0);
-
-    encodeAuthBase64();
+// create the databases, super tables and child tables and prepare the
+// sample data. a worker process only prepares the data, the coordinator
+// already created the schema before the workers were released
+static int prepareInsertSchema(bool create) {
     for (int i = 0; i < g_arguments->databases->size; ++i) {
         if (REST_IFACE == g_arguments->iface) {
             if (0 != convertServAddr(g_arguments->iface,
@@ -2543,7 +3678,7 @@ int insertTestProcess() {
         }
         SDataBase * database = benchArrayGet(g_arguments->databases, i);
 
-        if (database->drop && !(g_arguments->supplementInsert)) {
+        if (create && database->drop && !(g_arguments->supplementInsert)) {
             if (database->superTbls) {
                 SSuperTable * stbInfo = benchArrayGet(database->superTbls, 0);
                 if (stbInfo && (REST_IFACE == stbInfo->iface)) {
@@ -2559,14 +3694,23 @@ int insertTestProcess() {
             }
         }
     }
+    int32_t stable = 0;
     for (int i = 0; i < g_arguments->databases->size; ++i) {
         SDataBase * database = benchArrayGet(g_arguments->databases, i);
         if (database->superTbls) {
-            for (int j = 0; j < database->superTbls->size; ++j) {
+            for (int j = 0; j < database->superTbls->size; ++j, ++stable) {
                 SSuperTable * stbInfo = benchArrayGet(database->superTbls, j);
                 if (stbInfo->iface != SML_IFACE && stbInfo->iface != SML_REST_IFACE) {
-                    if (getSuperTableFromServer(database, stbInfo)) {
+                    if (!create) {
+                        // follow the schema the coordinator ended up with
+                        if (*procStableFromServer(stable)
+                                && getSuperTableFromServer(database, stbInfo)) {
+                            return -1;
+                        }
+                    } else if (getSuperTableFromServer(database, stbInfo)) {
                         if (createSuperTable(database, stbInfo)) return -1;
+                    } else if (g_procShm) {
+                        *procStableFromServer(stable) = 1;
                     }
                 }
                 if (0 != prepareSampleData(database, stbInfo)) {
@@ -2577,7 +3721,7 @@ int insertTestProcess() {
 
     }
 
-    if (g_arguments->taosc_version == 3) {
+    if (create && g_arguments->taosc_version == 3) {
         for (int i = 0; i < g_arguments->databases->size; i++) {
             SDataBase* database = benchArrayGet(g_arguments->databases, i);
             if (database->superTbls) {
@@ -2602,6 +3746,18 @@ int insertTestProcess() {
         }
     }
 
+    if (REST_IFACE != g_arguments->iface) {
+        // both the table creation and the insert threads draw from the
+        // pool, the coordinator of worker processes only creates tables
+        benchConnPoolWarmup(!create ? g_arguments->nthreads
+                            : g_procShm ? g_arguments->table_threads
+                            : max(g_arguments->table_threads,
+                                  g_arguments->nthreads));
+    }
+    if (!create) {
+        return 0;
+    }
+
     if (createChildTables()) return -1;
 
     if (g_arguments->taosc_version == 3) {
@@ -2614,7 +3770,10 @@ int insertTestProcess() {
             }
         }
     }
+    return 0;
+}
 
+static int insertAllStables() {
     // create sub threads for inserting data
     for (int i = 0; i < g_arguments->databases->size; i++) {
         SDataBase * database = benchArrayGet(g_arguments->databases, i);
@@ -2633,3 +3792,252 @@ int insertTestProcess() {
     }
     return 0;
 }
+
+#ifdef LINUX
+static void insertWorkerInterrupt(int32_t signum, void *sigInfo,
+                                  void *context) {
+    g_arguments->terminate = true;
+}
+
+static int runInsertWorker() {
+    benchSetSignal(SIGINT, insertWorkerInterrupt);
+    // the coordinator already asked before forking
+    g_arguments->answer_yes = true;
+    while (PROC_WAIT == g_procShm->state && !g_arguments->terminate) {
+        toolsMsleep(10);
+    }
+    int code = -1;
+    if (PROC_GO == g_procShm->state && !g_arguments->terminate
+            && 0 == prepareInsertSchema(false)) {
+        code = insertAllStables();
+    }
+    waitInsertWorkersReady();
+    postFreeResource();
+    return code;
+}
+
+static void sampleInsertWorkers(SBenchHist *hist, int64_t *cur) {
+    memset(cur, 0, sizeof(int64_t) * STAT_COUNT);
+    benchHistReset(hist);
+    for (int32_t p = 0; p < g_procShm->count; p++) {
+        SBenchProcStat *stat = g_procShm->procs + p;
+        for (int s = 0; s < STAT_COUNT; s++) {
+            cur[s] += atomic_add_fetch_64(&stat->stats[s], 0);
+        }
+        lockProcStat(stat);
+        benchHistMerge(hist, &stat->hist);
+        benchHistReset(&stat->hist);
+        pthread_mutex_unlock(&stat->lock);
+    }
+}
+
+// reap the workers, printing the merged statistics every interval. the
+// workers are released into PROC_RUN once all of them are set up or gone,
+// *start is when that happened
+static int watchInsertWorkers(pid_t *pids, int32_t count, int64_t *start) {
+    FILE *fp = NULL;
+    char  path[MAX_PATH_LEN];
+    if (g_arguments->report_interval > 0) {
+        snprintf(path, MAX_PATH_LEN, "%s.jsonl", g_arguments->output_file);
+        fp = fopen(path, "a");
+        if (NULL == fp) {
+            errorPrint("failed to open %s for interval report, reason: %s\n",
+                       path, strerror(errno));
+        }
+    }
+    int64_t intervalUs = (int64_t)(g_arguments->report_interval > 0
+                                   ? g_arguments->report_interval
+                                   : LIVE_REPORT_INTERVAL) * 1000000;
+    SBenchHist *hist = benchHistInit();
+    int64_t     last[STAT_COUNT] = {0};
+    int64_t     cur[STAT_COUNT];
+    int64_t     begin = benchGetMonotonicUs();
+    int64_t     lastTs = begin;
+    int32_t     running = count;
+    bool        forwarded = false;
+    int         code = 0;
+
+    while (running > 0) {
+        toolsMsleep(100);
+        for (int32_t p = 0; p < count; p++) {
+            int status = 0;
+            if (pids[p] <= 0 || waitpid(pids[p], &status, WNOHANG) != pids[p]) {
+                continue;
+            }
+            if (!WIFEXITED(status) || EXIT_SUCCESS != WEXITSTATUS(status)) {
+                errorPrint("process[%d] (pid %d) failed\n", p, pids[p]);
+                code = -1;
+            }
+            pids[p] = 0;
+            running--;
+        }
+        if (PROC_GO == g_procShm->state) {
+            int32_t ready = 0;
+            for (int32_t p = 0; p < count; p++) {
+                ready += g_procShm->procs[p].ready || pids[p] <= 0;
+            }
+            if (ready == count) {
+                begin = lastTs = *start = benchGetMonotonicUs();
+                g_procShm->state = PROC_RUN;
+            }
+        }
+        if (g_arguments->terminate && !forwarded) {
+            for (int32_t p = 0; p < count; p++) {
+                if (pids[p] > 0) {
+                    kill(pids[p], SIGINT);
+                }
+            }
+            forwarded = true;
+        }
+
+        int64_t now = benchGetMonotonicUs();
+        if (PROC_RUN != g_procShm->state
+                || (running > 0 && now - lastTs < intervalUs)) {
+            continue;
+        }
+        sampleInsertWorkers(hist, cur);
+        if (fp) {
+            writeInsertReport(fp, hist, cur, last, now - lastTs, now - begin);
+        }
+        infoPrint("%d of %d process(es) running, %.2f records/second, "
+                  "%" PRId64 " rows in total, p99 latency %.3fms\n",
+                  running, count,
+                  (cur[STAT_ROWS] - last[STAT_ROWS])
+                  / ((now - lastTs) > 0 ? (now - lastTs) / 1E6 : 1),
+                  cur[STAT_ROWS], benchHistPercentile(hist, 99) / 1E3);
+        memcpy(last, cur, sizeof(last));
+        lastTs = now;
+    }
+    benchHistDestroy(hist);
+    if (fp) {
+        fclose(fp);
+    }
+    return code;
+}
+
+static int runInsertProcesses() {
+    int32_t count = g_arguments->processes;
+    int32_t stables = 0;
+    for (int i = 0; i < g_arguments->databases->size; i++) {
+        SDataBase *database = benchArrayGet(g_arguments->databases, i);
+        if (database->superTbls) {
+            stables += database->superTbls->size;
+        }
+    }
+    size_t size = sizeof(SBenchProcShm) + count * sizeof(SBenchProcStat)
+        + stables;
+    g_procShm = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == g_procShm) {
+        errorPrint("failed to map shared memory for %d processes, "
+                   "reason: %s\n", count, strerror(errno));
+        g_procShm = NULL;
+        return -1;
+    }
+    g_procShm->state = PROC_WAIT;
+    g_procShm->count = count;
+    g_procShm->stables = stables;
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    for (int32_t p = 0; p < count; p++) {
+        SBenchProcStat *stat = g_procShm->procs + p;
+        pthread_mutex_init(&stat->lock, &attr);
+        benchHistReset(&stat->hist);
+        benchHistReset(&stat->total);
+    }
+    pthread_mutexattr_destroy(&attr);
+
+    // fork before any connection is made, the client library does not
+    // survive a fork. nothing buffered may be written twice either
+    fflush(NULL);
+    pid_t *pids = benchCalloc(count, sizeof(pid_t), true);
+    int32_t forked = 0;
+    for (; forked < count; forked++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            errorPrint("fork() failed, reason: %s\n", strerror(errno));
+            break;
+        }
+        if (0 == pid) {
+            g_procIndex = forked;
+            g_procStat = g_procShm->procs + forked;
+            exit(runInsertWorker() ? EXIT_FAILURE : EXIT_SUCCESS);
+        }
+        pids[forked] = pid;
+    }
+    infoPrint("forked %d worker process(es) for insertion\n", forked);
+
+    int code = forked < count ? -1 : prepareInsertSchema(true);
+    if (code || g_arguments->terminate) {
+        g_procShm->state = PROC_ABORT;
+    } else {
+        g_procShm->state = PROC_GO;
+    }
+    int64_t start = benchGetMonotonicUs();
+    if (watchInsertWorkers(pids, forked, &start)) {
+        code = -1;
+    }
+    int64_t end = benchGetMonotonicUs() + 1;
+
+    if (PROC_RUN == g_procShm->state) {
+        SBenchHist *totalHist = benchHistInit();
+        int64_t     stats[STAT_COUNT] = {0};
+        for (int32_t p = 0; p < count; p++) {
+            SBenchProcStat *stat = g_procShm->procs + p;
+            for (int s = 0; s < STAT_COUNT; s++) {
+                stats[s] += stat->stats[s];
+            }
+            lockProcStat(stat);
+            benchHistMerge(totalHist, &stat->total);
+            pthread_mutex_unlock(&stat->lock);
+        }
+        succPrint("Spent %.6f seconds to insert rows: %" PRId64
+                  " with %d process(es) of %d thread(s) %.2f records/second\n",
+                  (end - start)/1E6, stats[STAT_ROWS], count,
+                  g_arguments->nthreads,
+                  stats[STAT_ROWS] / ((end - start)/1E6));
+        if (g_arguments->rest_codec != REST_CODEC_NONE
+                && stats[STAT_BYTES] > 0) {
+            succPrint("sent %" PRId64 " bytes compressed from %" PRId64
+                      " raw bytes with %s, ratio %.2f%%\n",
+                      stats[STAT_WIRE_BYTES], stats[STAT_BYTES],
+                      benchHttpEncoding(),
+                      stats[STAT_WIRE_BYTES] * 100.0 / stats[STAT_BYTES]);
+        }
+        if (totalHist->count) {
+            printInsertDelay(totalHist);
+        }
+        benchHistDestroy(totalHist);
+    }
+
+    tmfree(pids);
+    for (int32_t p = 0; p < count; p++) {
+        pthread_mutex_destroy(&g_procShm->procs[p].lock);
+    }
+    munmap(g_procShm, size);
+    g_procShm = NULL;
+    return code;
+}
+#endif
+
+int insertTestProcess() {
+
+    infoPrint("random seed: %" PRIu64 "\n", g_arguments->random_seed);
+    prompt(0);
+
+    encodeAuthBase64();
+    if (g_arguments->processes > 1) {
+#ifdef LINUX
+        return runInsertProcesses();
+#else
+        warnPrint("%s", "processes is only supported on Linux, "
+                  "will insert in one process\n");
+#endif
+    }
+    if (prepareInsertSchema(true)) {
+        return -1;
+    }
+    return insertAllStables();
+}
@@ -14,6 +14,78 @@
 
 extern char      g_configDir[MAX_PATH_LEN];
 
+static double getJsonDouble(tools_cJSON *obj, const char *key,
+                            double defaultValue) {
+    tools_cJSON *item = tools_cJSON_GetObjectItem(obj, key);
+    return tools_cJSON_IsNumber(item) ? item->valuedouble : defaultValue;
+}
+
+// value generator of a column, see enumBENCH_GEN. zipf ranks count up
+// from min, so they must fit in [min, max]
+static int getColumnGenFromJson(tools_cJSON *column, uint8_t type,
+                                int64_t min, int64_t *max,
+                                SBenchGen *gen, double *nullRatio) {
+    memset(gen, 0, sizeof(SBenchGen));
+    *nullRatio = getJsonDouble(column, "null_ratio", 0);
+    if (*nullRatio < 0 || *nullRatio > 100) {
+        errorPrint("invalid null_ratio %f, should be 0 ~ 100\n", *nullRatio);
+        return -1;
+    }
+
+    tools_cJSON *genObj = tools_cJSON_GetObjectItem(column, "gen");
+    if (!tools_cJSON_IsString(genObj)
+            || 0 == strcasecmp(genObj->valuestring, "uniform")) {
+        gen->kind = BENCH_GEN_UNIFORM;
+        return 0;
+    }
+    if (0 == strcasecmp(genObj->valuestring, "random_walk")) {
+        gen->kind = BENCH_GEN_RANDOM_WALK;
+    } else if (0 == strcasecmp(genObj->valuestring, "sine")) {
+        gen->kind = BENCH_GEN_SINE;
+    } else if (0 == strcasecmp(genObj->valuestring, "counter")) {
+        gen->kind = BENCH_GEN_COUNTER;
+    } else if (0 == strcasecmp(genObj->valuestring, "rare_change")) {
+        gen->kind = BENCH_GEN_RARE_CHANGE;
+    } else if (0 == strcasecmp(genObj->valuestring, "zipf")) {
+        gen->kind = BENCH_GEN_ZIPF;
+    } else {
+        errorPrint("unknown column generator: %s\n", genObj->valuestring);
+        return -1;
+    }
+    if (type == TSDB_DATA_TYPE_TIMESTAMP || type == TSDB_DATA_TYPE_JSON
+            || ((type == TSDB_DATA_TYPE_BINARY
+                 || type == TSDB_DATA_TYPE_NCHAR)
+                && gen->kind != BENCH_GEN_ZIPF)) {
+        errorPrint("generator %s does not apply to column type %s\n",
+                   genObj->valuestring, convertDatatypeToString(type));
+        return -1;
+    }
+    gen->step = getJsonDouble(column, "step", 1);
+    gen->period = getJsonDouble(column, "period", 1000);
+    gen->noise = getJsonDouble(column, "noise", 0);
+    gen->change = getJsonDouble(column, "change", 0.001);
+    gen->zipfS = getJsonDouble(column, "zipf_s", 1.0);
+    gen->categories = (int32_t)getJsonDouble(column, "categories", 100);
+    if (gen->period <= 0 || gen->categories <= 0
+            || gen->change < 0 || gen->change > 1) {
+        errorPrint("invalid parameters of column generator %s\n",
+                   genObj->valuestring);
+        return -1;
+    }
+    if (gen->kind == BENCH_GEN_ZIPF) {
+        if (type == TSDB_DATA_TYPE_BINARY || type == TSDB_DATA_TYPE_NCHAR) {
+            // a string column has no range of its own, the ranks are it
+            *max = min + gen->categories - 1;
+        } else if (gen->categories > *max - min + 1) {
+            errorPrint("zipf categories %d exceed the range [%" PRId64
+                       ", %" PRId64 "] of the column\n",
+                       gen->categories, min, *max);
+            return -1;
+        }
+    }
+    return 0;
+}
+
 static int getColumnAndTagTypeFromInsertJsonFile(
     tools_cJSON * superTblObj, SSuperTable *stbInfo) {
     int32_t code = -1;
@@ -99,6 +171,13 @@ static int getColumnAndTagTypeFromInsertJsonFile(
             }
         }
 
+        SBenchGen gen;
+        double    nullRatio;
+        if (getColumnGenFromJson(column, type, min, &max,
+                                 &gen, &nullRatio)) {
+            goto PARSE_OVER;
+        }
+
         for (int n = 0; n < count; ++n) {
             Field * col = benchCalloc(1, sizeof(Field), true);
             benchArrayPush(stbInfo->cols, col);
@@ -112,6 +191,11 @@ static int getColumnAndTagTypeFromInsertJsonFile(
             col->max = max;
             col->min = min;
             col->values = dataValues;
+            col->gen = gen;
+            col->nullRatio = nullRatio;
+            if (gen.kind == BENCH_GEN_ZIPF) {
+                benchGenInitZipf(&col->gen);
+            }
             if (customName) {
                 if (n >= 1) {
                     sprintf(col->name, "%s_%d", dataName->valuestring, n);
@@ -450,6 +534,9 @@ static int getStableInfo(tools_cJSON *dbinfos, int index) {
             tools_cJSON_GetObjectItem(stbInfo, "batch_create_tbl_num");
         if (tools_cJSON_IsNumber(batchCreateTbl)) {
             superTable->batchCreateTableNum = batchCreateTbl->valueint;
+        } else if (tools_cJSON_IsString(batchCreateTbl)
+                   && 0 == strcasecmp(batchCreateTbl->valuestring, "auto")) {
+            superTable->batchCreateAuto = true;
         }
         tools_cJSON *childTblExists =
             tools_cJSON_GetObjectItem(stbInfo, "child_table_exists");
@@ -869,6 +956,10 @@ static int getMetaFromInsertJsonFile(tools_cJSON *json) {
     if (numRecPerReq && numRecPerReq->type == tools_cJSON_Number) {
         g_arguments->reqPerReq = (uint32_t)numRecPerReq->valueint;
         if (g_arguments->reqPerReq <= 0) goto PARSE_OVER;
+    } else if (tools_cJSON_IsString(numRecPerReq)
+               && 0 == strcasecmp(numRecPerReq->valuestring, "auto")) {
+        g_arguments->reqPerReqAuto = true;
+        g_arguments->reqPerReq = AUTO_REQ_PER_REQ_MAX;
     }
 
     tools_cJSON *prepareRand =
@@ -877,6 +968,82 @@ static int getMetaFromInsertJsonFile(tools_cJSON *json) {
         g_arguments->prepared_rand = prepareRand->valueint;
     }
 
+    tools_cJSON *randomSeed =
+        tools_cJSON_GetObjectItem(json, "random_seed");
+    if (tools_cJSON_IsNumber(randomSeed)) {
+        g_arguments->random_seed = (uint64_t)randomSeed->valueint;
+    }
+
+    tools_cJSON *reportInterval =
+        tools_cJSON_GetObjectItem(json, "report_interval");
+    if (tools_cJSON_IsNumber(reportInterval)) {
+        g_arguments->report_interval = (int32_t)reportInterval->valueint;
+    }
+
+    tools_cJSON *processes = tools_cJSON_GetObjectItem(json, "processes");
+    if (tools_cJSON_IsNumber(processes)) {
+        if (processes->valueint < 1) {
+            errorPrint("invalid value for processes: %"PRId64"\n",
+                       (int64_t)processes->valueint);
+            goto PARSE_OVER;
+        }
+        g_arguments->processes = (int32_t)processes->valueint;
+    }
+
+    tools_cJSON *createDepth =
+        tools_cJSON_GetObjectItem(json, "create_table_depth");
+    if (tools_cJSON_IsNumber(createDepth)) {
+        if (createDepth->valueint < 1) {
+            errorPrint("invalid value for create_table_depth: %"PRId64"\n",
+                       (int64_t)createDepth->valueint);
+            goto PARSE_OVER;
+        }
+        g_arguments->create_depth = (int32_t)createDepth->valueint;
+    }
+
+    tools_cJSON *affinity =
+        tools_cJSON_GetObjectItem(json, "thread_affinity");
+    if (tools_cJSON_IsString(affinity)) {
+        if (toolsSetAffinity(affinity->valuestring)) {
+            errorPrint("invalid value for thread_affinity: %s\n",
+                       affinity->valuestring);
+            goto PARSE_OVER;
+        }
+    }
+
+    tools_cJSON *targetRate = tools_cJSON_GetObjectItem(json, "target_rate");
+    if (tools_cJSON_IsNumber(targetRate)) {
+        g_arguments->target_rate = targetRate->valuedouble;
+    }
+
+    tools_cJSON *rateUnit =
+        tools_cJSON_GetObjectItem(json, "target_rate_unit");  // rows, requests
+    if (tools_cJSON_IsString(rateUnit)) {
+        if (0 == strcasecmp(rateUnit->valuestring, "requests")) {
+            g_arguments->rate_by_requests = true;
+        } else if (0 == strcasecmp(rateUnit->valuestring, "rows")) {
+            g_arguments->rate_by_requests = false;
+        } else {
+            errorPrint("invalid value for target_rate_unit: %s\n",
+                       rateUnit->valuestring);
+            goto PARSE_OVER;
+        }
+    }
+
+    tools_cJSON *rateScope =
+        tools_cJSON_GetObjectItem(json, "target_rate_scope");  // global, thread
+    if (tools_cJSON_IsString(rateScope)) {
+        if (0 == strcasecmp(rateScope->valuestring, "thread")) {
+            g_arguments->rate_per_thread = true;
+        } else if (0 == strcasecmp(rateScope->valuestring, "global")) {
+            g_arguments->rate_per_thread = false;
+        } else {
+            errorPrint("invalid value for target_rate_scope: %s\n",
+                       rateScope->valuestring);
+            goto PARSE_OVER;
+        }
+    }
+
     tools_cJSON *chineseOpt = tools_cJSON_GetObjectItem(json, "chinese");  // yes, no,
     if (chineseOpt && chineseOpt->type == tools_cJSON_String &&
         chineseOpt->valuestring != NULL) {
@@ -885,6 +1052,96 @@ static int getMetaFromInsertJsonFile(tools_cJSON *json) {
         }
     }
 
+    tools_cJSON *pipeline = tools_cJSON_GetObjectItem(json, "pipeline");  // yes, no
+    if (tools_cJSON_IsString(pipeline)) {
+        if (0 == strcasecmp(pipeline->valuestring, "yes")) {
+            g_arguments->pipeline = true;
+        } else if (0 == strcasecmp(pipeline->valuestring, "no")) {
+            g_arguments->pipeline = false;
+        } else {
+            errorPrint("invalid value for pipeline: %s\n",
+                       pipeline->valuestring);
+            goto PARSE_OVER;
+        }
+    }
+
+    tools_cJSON *restConnections =
+        tools_cJSON_GetObjectItem(json, "rest_connections");
+    if (tools_cJSON_IsNumber(restConnections)) {
+        g_arguments->rest_connections = (int32_t)restConnections->valueint;
+    }
+
+    tools_cJSON *restDepth = tools_cJSON_GetObjectItem(json, "rest_depth");
+    if (tools_cJSON_IsNumber(restDepth)) {
+        if (restDepth->valueint < 1) {
+            errorPrint("invalid value for rest_depth: %"PRId64"\n",
+                       (int64_t)restDepth->valueint);
+            goto PARSE_OVER;
+        }
+        g_arguments->rest_depth = (int32_t)restDepth->valueint;
+    }
+
+    tools_cJSON *restCodec =
+        tools_cJSON_GetObjectItem(json, "rest_compression");  // gzip, deflate, none
+    if (tools_cJSON_IsString(restCodec)) {
+        if (0 == strcasecmp(restCodec->valuestring, "gzip")) {
+            g_arguments->rest_codec = REST_CODEC_GZIP;
+        } else if (0 == strcasecmp(restCodec->valuestring, "deflate")) {
+            g_arguments->rest_codec = REST_CODEC_DEFLATE;
+        } else if (0 == strcasecmp(restCodec->valuestring, "none")) {
+            g_arguments->rest_codec = REST_CODEC_NONE;
+        } else {
+            errorPrint("invalid value for rest_compression: %s\n",
+                       restCodec->valuestring);
+            goto PARSE_OVER;
+        }
+#ifndef DEFLATE_CODEC
+        if (g_arguments->rest_codec != REST_CODEC_NONE) {
+            warnPrint("%s", "built without zlib, rest_compression is "
+                      "ignored\n");
+            g_arguments->rest_codec = REST_CODEC_NONE;
+        }
+#endif
+    }
+
+    tools_cJSON *restCodecLevel =
+        tools_cJSON_GetObjectItem(json, "rest_compression_level");
+    if (tools_cJSON_IsNumber(restCodecLevel)) {
+        if (restCodecLevel->valueint < 1 || restCodecLevel->valueint > 9) {
+            errorPrint("invalid value for rest_compression_level: %"PRId64
+                       ", should be 1 ~ 9\n",
+                       (int64_t)restCodecLevel->valueint);
+            goto PARSE_OVER;
+        }
+        g_arguments->rest_codec_level = (int32_t)restCodecLevel->valueint;
+    }
+
+    tools_cJSON *schedule =
+        tools_cJSON_GetObjectItem(json, "table_schedule");  // static, dynamic
+    if (tools_cJSON_IsString(schedule)) {
+        if (0 == strcasecmp(schedule->valuestring, "dynamic")) {
+            g_arguments->dynamic_schedule = true;
+        } else if (0 == strcasecmp(schedule->valuestring, "static")) {
+            g_arguments->dynamic_schedule = false;
+        } else {
+            errorPrint("invalid value for table_schedule: %s\n",
+                       schedule->valuestring);
+            goto PARSE_OVER;
+        }
+    }
+
+    tools_cJSON *scheduleChunk =
+        tools_cJSON_GetObjectItem(json, "schedule_chunk");
+    if (tools_cJSON_IsNumber(scheduleChunk)) {
+        g_arguments->schedule_chunk = scheduleChunk->valueint;
+    }
+
+    tools_cJSON *vgroupCache =
+        tools_cJSON_GetObjectItem(json, "vgroup_cache");  // directory
+    if (tools_cJSON_IsString(vgroupCache)) {
+        g_arguments->vgroup_cache = vgroupCache->valuestring;
+    }
+
     tools_cJSON *top_insertInterval =
         tools_cJSON_GetObjectItem(json, "insert_interval");
     if (top_insertInterval && top_insertInterval->type == tools_cJSON_Number) {
@@ -1169,10 +1426,6 @@ static int getMetaFromQueryJsonFile(tools_cJSON *json) {
                         g_queryInfo.specifiedQueryInfo.sqls->size - 1);
                 int bufLen = strlen(buf) + 1;
                 sql->command = benchCalloc(1, bufLen, true);
-                sql->delay_list = benchCalloc(
-                        g_queryInfo.specifiedQueryInfo.queryTimes
-                        * g_queryInfo.specifiedQueryInfo.concurrent,
-                        sizeof(int64_t), true);
                 tstrncpy(sql->command, buf, bufLen);
                 debugPrint("read file buffer: %s\n", sql->command);
                 memset(buf, 0, BUFFER_SIZE);
@@ -1192,10 +1445,6 @@ static int getMetaFromQueryJsonFile(tools_cJSON *json) {
                     benchArrayPush(g_queryInfo.specifiedQueryInfo.sqls, sql);
                     sql = benchArrayGet(g_queryInfo.specifiedQueryInfo.sqls,
                             g_queryInfo.specifiedQueryInfo.sqls->size -1);
-                    sql->delay_list = benchCalloc(
-                            g_queryInfo.specifiedQueryInfo.queryTimes
-                            * g_queryInfo.specifiedQueryInfo.concurrent,
-                            sizeof(int64_t), true);
 
                     tools_cJSON *sqlStr =
                         tools_cJSON_GetObjectItem(sqlObj, "sql");
@@ -24,7 +24,8 @@ int selectAndGetResult(threadInfo *pThreadInfo, char *command) {
     tstrncpy(dbName, g_queryInfo.dbName, TSDB_DB_NAME_LEN);
 
     if (g_queryInfo.iface == REST_IFACE) {
-        int retCode = postProceSql(command, g_queryInfo.dbName, 0, REST_IFACE,
+        int retCode = postProceSql(command, strlen(command),
+                                   g_queryInfo.dbName, 0, REST_IFACE,
                                    0, g_arguments->port, false,
                                    pThreadInfo->sockfd, pThreadInfo->filePath);
         if (0 != retCode) {
@@ -34,7 +35,7 @@ int selectAndGetResult(threadInfo *pThreadInfo, char *command) {
         }
     } else {
         TAOS *taos = pThreadInfo->conn->taos;
-        if (taos_select_db(taos, g_queryInfo.dbName)) {
+        if (benchSelectDb(pThreadInfo->conn, g_queryInfo.dbName)) {
             errorPrint("thread[%u]: failed to select database(%s)\n",
                 threadID, dbName);
             ret = -2;
@@ -65,6 +66,7 @@ static void *mixedQuery(void *sarg) {
 #ifdef LINUX
     prctl(PR_SET_NAME, "mixedQuery");
 #endif
+    benchBindThread(pThreadInfo->threadId);
     int64_t lastPrintTs = toolsGetTimestampMs();
     int64_t st;
     int64_t et;
@@ -78,9 +80,10 @@ static void *mixedQuery(void *sarg) {
             if (g_queryInfo.reset_query_cache) {
                 queryDbExec(pThreadInfo->conn, "reset query cache");
             }
-            st = toolsGetTimestampUs();
+            st = benchGetMonotonicUs();
             if (g_queryInfo.iface == REST_IFACE) {
-                int retCode = postProceSql(sql->command, g_queryInfo.dbName,
+                int retCode = postProceSql(sql->command, strlen(sql->command),
+                                           g_queryInfo.dbName,
                                            0, g_queryInfo.iface, 0, g_arguments->port,
                                            false, pThreadInfo->sockfd, "");
                 if (retCode) {
@@ -90,7 +93,7 @@ static void *mixedQuery(void *sarg) {
                 }
             } else {
                 if (g_queryInfo.dbName != NULL) {
-                    if (taos_select_db(pThreadInfo->conn->taos, g_queryInfo.dbName)) {
+                    if (benchSelectDb(pThreadInfo->conn, g_queryInfo.dbName)) {
                         errorPrint("thread[%d]: failed to select database(%s)\n",
                                 pThreadInfo->threadId, g_queryInfo.dbName);
                         return NULL;
@@ -121,18 +124,17 @@ static void *mixedQuery(void *sarg) {
                 }
                 taos_free_result(res);
             }
-            et = toolsGetTimestampUs();
-            int64_t* delay = benchCalloc(1, sizeof(int64_t), false);
-            *delay = et - st;
-            debugPrint("%s() LN%d, delay: %"PRId64"\n", __func__, __LINE__, *delay);
+            et = benchGetMonotonicUs();
+            int64_t delay = et - st;
+            debugPrint("%s() LN%d, delay: %"PRId64"\n", __func__, __LINE__, delay);
 
-            pThreadInfo->total_delay += (et - st);
-            benchArrayPush(pThreadInfo->query_delay_list, delay);
+            pThreadInfo->total_delay += delay;
+            benchHistRecord(pThreadInfo->query_delay_hist, delay);
             int64_t currentPrintTs = toolsGetTimestampMs();
             if (currentPrintTs - lastPrintTs > 10 * 1000) {
-                infoPrint("thread[%d] has currently complete query %d times\n",
+                infoPrint("thread[%d] has currently complete query %"PRIu64" times\n",
                         pThreadInfo->threadId,
-                        (int)pThreadInfo->query_delay_list->size);
+                        pThreadInfo->query_delay_hist->count);
                 lastPrintTs = currentPrintTs;
             }
         }
@@ -145,6 +147,7 @@ static void *specifiedTableQuery(void *sarg) {
 #ifdef LINUX
     prctl(PR_SET_NAME, "specTableQuery");
 #endif
+    benchBindThread(pThreadInfo->threadID);
     uint64_t st = 0;
     uint64_t et = 0;
     uint64_t minDelay = UINT64_MAX;
@@ -153,8 +156,6 @@ static void *specifiedTableQuery(void *sarg) {
     int32_t  index = 0;
 
     uint64_t  queryTimes = g_queryInfo.specifiedQueryInfo.queryTimes;
-    pThreadInfo->query_delay_list = benchCalloc(queryTimes,
-            sizeof(uint64_t), false);
     uint64_t  lastPrintTime = toolsGetTimestampMs();
     uint64_t  startTs = toolsGetTimestampMs();
 
@@ -178,18 +179,18 @@ static void *specifiedTableQuery(void *sarg) {
             queryDbExec(pThreadInfo->conn, "reset query cache");
         }
 
-        st = toolsGetTimestampUs();
+        st = benchGetMonotonicUs();
         int ret = selectAndGetResult(pThreadInfo, sql->command);
         if (ret) {
             g_fail = true;
         }
 
-        et = toolsGetTimestampUs();
+        et = benchGetMonotonicUs();
         int64_t delay = et - st;
         debugPrint("%s() LN%d, delay: %"PRId64"\n", __func__, __LINE__, delay);
 
         if (ret == 0) {
-            pThreadInfo->query_delay_list[index] = delay;
+            benchHistRecord(pThreadInfo->delayHist, delay);
             pThreadInfo->totalQueried++;
         }
         index++;
@@ -216,12 +217,12 @@ static void *specifiedTableQuery(void *sarg) {
 
         if (-2 == ret) {
             toolsMsleep(1000);
+            benchHttpRelease();
             return NULL;
         }
     }
-    qsort(pThreadInfo->query_delay_list, queryTimes,
-            sizeof(uint64_t), compare);
     pThreadInfo->avg_delay = (double)totalDelay / queryTimes;
+    benchHttpRelease();
     return NULL;
 }
 
@@ -231,6 +232,7 @@ static void *superTableQuery(void *sarg) {
 #ifdef LINUX
     prctl(PR_SET_NAME, "superTableQuery");
 #endif
+    benchBindThread(pThreadInfo->threadID);
 
     uint64_t st = 0;
     uint64_t et = (int64_t)g_queryInfo.superQueryInfo.queryInterval*1000;
@@ -280,6 +282,7 @@ static void *superTableQuery(void *sarg) {
         et = toolsGetTimestampMs();
     }
     tmfree(sqlstr);
+    benchHttpRelease();
     return NULL;
 }
 
@@ -382,6 +385,7 @@ static int multi_thread_specified_table_query(uint16_t iface, char* dbName) {
                 threadInfo *pThreadInfo = infos + seq;
                 pThreadInfo->threadID = (int)seq;
                 pThreadInfo->querySeq = i;
+                pThreadInfo->delayHist = benchHistInit();
                 if (iface == REST_IFACE) {
                     int sockfd = createSockFd();
                     // int iMode = 1;
@@ -420,7 +424,7 @@ static int multi_thread_specified_table_query(uint16_t iface, char* dbName) {
                     close_bench_conn(pThreadInfo->conn);
                 }
                 if (g_fail) {
-                    tmfree(pThreadInfo->query_delay_list);
+                    benchHistDestroy(pThreadInfo->delayHist);
                 }
             }
 
@@ -430,40 +434,42 @@ static int multi_thread_specified_table_query(uint16_t iface, char* dbName) {
                 return -1;
             }
             uint64_t query_times = g_queryInfo.specifiedQueryInfo.queryTimes;
-            uint64_t total_query_times = query_times * nConcurrent;
+            SBenchHist *hist = benchHistInit();
             double avg_delay = 0.0;
             for (int j = 0; j < nConcurrent; j++) {
                 uint64_t    seq = i * nConcurrent + j;
                 threadInfo *pThreadInfo = infos + seq;
                 avg_delay += pThreadInfo->avg_delay;
-                for (uint64_t k = 0;
-                        k < g_queryInfo.specifiedQueryInfo.queryTimes; k++) {
-                    sql->delay_list[j*query_times + k] =
-                        pThreadInfo->query_delay_list[k];
-                }
-                tmfree(pThreadInfo->query_delay_list);
+                benchHistMerge(hist, pThreadInfo->delayHist);
+                benchHistDestroy(pThreadInfo->delayHist);
             }
             avg_delay /= nConcurrent;
-            qsort(sql->delay_list, total_query_times, sizeof(uint64_t), compare);
             infoPrintNoTimestamp("complete query with %d threads and %"PRIu64
                     " query delay "
                     "avg: \t%.6fs "
                     "min: \t%.6fs "
                     "max: \t%.6fs "
+                    "p50: \t%.6fs "
                     "p90: \t%.6fs "
                     "p95: \t%.6fs "
                     "p99: \t%.6fs "
+                    "p99.9: \t%.6fs "
+                    "p99.99: \t%.6fs "
                     "SQL command: %s"
                     "\n",
                       nConcurrent, query_times,
                       avg_delay/1E6,  /* avg */
-                      sql->delay_list[0]/1E6, /* min */
-                      sql->delay_list[(int32_t)total_query_times - 1]/1E6,  /*  max */
-                      sql->delay_list[(int32_t)(total_query_times * 0.90)]/1E6, /*  p90 */
-                      sql->delay_list[(int32_t)(total_query_times * 0.95)]/1E6, /*  p95 */
-                      sql->delay_list[(int32_t)(total_query_times * 0.99)]/1E6,  /* p88 */
+                      (hist->count ? hist->min : 0)/1E6, /* min */
+                      hist->max/1E6,  /*  max */
+                      benchHistPercentile(hist, 50)/1E6, /*  p50 */
+                      benchHistPercentile(hist, 90)/1E6, /*  p90 */
+                      benchHistPercentile(hist, 95)/1E6, /*  p95 */
+                      benchHistPercentile(hist, 99)/1E6,  /* p99 */
+                      benchHistPercentile(hist, 99.9)/1E6,  /* p99.9 */
+                      benchHistPercentile(hist, 99.99)/1E6,  /* p99.99 */
                       sql->command
                       );
+            benchHistDestroy(hist);
         }
     } else {
         return 0;
@@ -474,7 +480,6 @@ static int multi_thread_specified_table_query(uint16_t iface, char* dbName) {
     for (int i = 0; i < g_queryInfo.specifiedQueryInfo.sqls->size; ++i) {
         SSQL * sql = benchArrayGet(g_queryInfo.specifiedQueryInfo.sqls, i);
         tmfree(sql->command);
-        tmfree(sql->delay_list);
     }
     benchArrayDestroy(g_queryInfo.specifiedQueryInfo.sqls);
     return 0;
@@ -503,7 +508,7 @@ static int multi_thread_specified_mixed_query(uint16_t iface, char* dbName) {
         pQueryThreadInfo->end_sql = i < b ? start_sql + a : start_sql + a - 1;
         start_sql = pQueryThreadInfo->end_sql + 1;
         pQueryThreadInfo->total_delay = 0;
-        pQueryThreadInfo->query_delay_list = benchArrayInit(1, sizeof(int64_t));
+        pQueryThreadInfo->query_delay_hist = benchHistInit();
         if (iface == REST_IFACE) {
             int sockfd = createSockFd();
             if (sockfd < 0) {
@@ -519,22 +524,21 @@ static int multi_thread_specified_mixed_query(uint16_t iface, char* dbName) {
         pthread_create(pids + i, NULL, mixedQuery, pQueryThreadInfo);
     }
 
-    int64_t start = toolsGetTimestampUs();
+    int64_t start = benchGetMonotonicUs();
     for (int i = 0; i < thread; ++i) {
 // temporary disabled       pthread_cancel(pids[i]);
         pthread_join(pids[i], NULL);
     }
-    int64_t end = toolsGetTimestampUs();
+    int64_t end = benchGetMonotonicUs();
 
     //statistic
-    BArray * delay_list = benchArrayInit(1, sizeof(int64_t));
+    SBenchHist * hist = benchHistInit();
     int64_t total_delay = 0;
     for (int i = 0; i < thread; ++i) {
         queryThreadInfo * pThreadInfo = infos + i;
-        benchArrayAddBatch(delay_list, pThreadInfo->query_delay_list->pData,
-                pThreadInfo->query_delay_list->size);
+        benchHistMerge(hist, pThreadInfo->query_delay_hist);
         total_delay += pThreadInfo->total_delay;
-        tmfree(pThreadInfo->query_delay_list);
+        benchHistDestroy(pThreadInfo->query_delay_hist);
         if (iface == REST_IFACE) {
 #ifdef  WINDOWS
             closesocket(pThreadInfo->sockfd);
@@ -546,34 +550,35 @@ static int multi_thread_specified_mixed_query(uint16_t iface, char* dbName) {
             close_bench_conn(pThreadInfo->conn);
         }
     }
-    qsort(delay_list->pData, delay_list->size, delay_list->elemSize, compare);
-    if (delay_list->size) {
+    if (hist->count) {
         infoPrint(
                 "spend %.6fs using "
-                "%d threads complete query %d times,cd  "
+                "%d threads complete query %"PRIu64" times,  "
                 "min delay: %.6fs, "
                 "avg delay: %.6fs, "
+                "p50: %.6fs, "
                 "p90: %.6fs, "
                 "p95: %.6fs, "
                 "p99: %.6fs, "
+                "p99.9: %.6fs, "
+                "p99.99: %.6fs, "
                 "max: %.6fs\n",
                 (end - start)/1E6,
-                thread, (int)delay_list->size,
-                *(int64_t *)(benchArrayGet(delay_list, 0))/1E6,
-                (double)total_delay/delay_list->size/1E6,
-                *(int64_t *)(benchArrayGet(delay_list,
-                                           (int32_t)(delay_list->size * 0.9)))/1E6,
-                *(int64_t *)(benchArrayGet(delay_list,
-                                           (int32_t)(delay_list->size * 0.95)))/1E6,
-                *(int64_t *)(benchArrayGet(delay_list,
-                                           (int32_t)(delay_list->size * 0.99)))/1E6,
-                *(int64_t *)(benchArrayGet(delay_list,
-                                           (int32_t)(delay_list->size - 1)))/1E6);
+                thread, hist->count,
+                hist->min/1E6,
+                (double)total_delay/hist->count/1E6,
+                benchHistPercentile(hist, 50)/1E6,
+                benchHistPercentile(hist, 90)/1E6,
+                benchHistPercentile(hist, 95)/1E6,
+                benchHistPercentile(hist, 99)/1E6,
+                benchHistPercentile(hist, 99.9)/1E6,
+                benchHistPercentile(hist, 99.99)/1E6,
+                hist->max/1E6);
     } else {
-        errorPrint("%s() LN%d, delay_list size: %"PRId64"\n",
-                   __func__, __LINE__, (int64_t)delay_list->size);
+        errorPrint("%s() LN%d, delay_list size: %"PRIu64"\n",
+                   __func__, __LINE__, hist->count);
     }
-    benchArrayDestroy(delay_list);
+    benchHistDestroy(hist);
     code = 0;
 OVER:
     tmfree(pids);
@@ -587,16 +592,34 @@ void *queryKiller(void *arg) {
     char host[MAX_HOSTNAME_LEN] = {0};
     tstrncpy(host, g_arguments->host, MAX_HOSTNAME_LEN);
 
-    while (true) {
-        TAOS *taos = taos_connect(g_arguments->host, g_arguments->user,
-                g_arguments->password, NULL, g_arguments->port);
-        if (NULL == taos) {
-            errorPrint("Slow query killer thread "
-                    "failed to connect to the server %s\n",
-                    g_arguments->host);
-            return NULL;
+    // one connection serves every round of the killer. it issues native
+    // client calls, so a websocket run gets a native connection of its own
+    SBenchConn *conn = NULL;
+    TAOS *      taos = NULL;
+#ifdef WEBSOCKET
+    if (g_arguments->websocket) {
+        taos = taos_connect(g_arguments->host, g_arguments->user,
+                            g_arguments->password, NULL, g_arguments->port);
+    } else {
+#endif
+        conn = init_bench_conn();
+        if (conn) {
+            taos = conn->taos;
+        }
+#ifdef WEBSOCKET
+    }
+#endif
+    if (NULL == taos) {
+        errorPrint("Slow query killer thread "
+                "failed to connect to the server %s\n",
+                g_arguments->host);
+        if (conn) {
+            close_bench_conn(conn);
         }
+        return NULL;
+    }
 
+    while (true) {
         char command[TSDB_MAX_ALLOWED_SQL_LEN] =
             "SELECT kill_id,exec_usec,sql FROM performance_schema.perf_queries";
         TAOS_RES *res = taos_query(taos, command);
@@ -635,10 +658,14 @@ void *queryKiller(void *arg) {
         }
 
         taos_free_result(res);
-        taos_close(taos);
         toolsMsleep(g_queryInfo.killQueryInterval*1000);
     }
 
+    if (conn) {
+        close_bench_conn(conn);
+    } else {
+        taos_close(taos);
+    }
     return NULL;
 }
 
@@ -718,6 +745,11 @@ int queryTestProcess() {
         close_bench_conn(conn);
     }
 
+    if (g_queryInfo.iface != REST_IFACE) {
+        benchConnPoolWarmup(max(g_queryInfo.specifiedQueryInfo.concurrent,
+                                g_queryInfo.superQueryInfo.threadCnt));
+    }
+
     uint64_t startTs = toolsGetTimestampMs();
 
     if (g_queryInfo.specifiedQueryInfo.mixed_query) {
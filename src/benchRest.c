@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the MIT license as published by the Free Software
+ * Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "bench.h"
+
+#ifdef LINUX
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+
+#define REST_MAX_EVENTS     64
+#define REST_MAX_RECONNECTS 3
+
+static SBenchRestReq *restAt(SBenchRest *rest, SBenchRestConn *conn,
+                             int32_t i) {
+    return rest->reqs + conn->ring[(conn->head + i) % rest->depth];
+}
+
+static int32_t restWatch(SBenchRest *rest, SBenchRestConn *conn,
+                         bool wantWrite) {
+    if (conn->wantWrite == wantWrite) {
+        return 0;
+    }
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN | (wantWrite ? EPOLLOUT : 0);
+    ev.data.ptr = conn;
+    if (epoll_ctl(rest->epfd, EPOLL_CTL_MOD, conn->fd, &ev)) {
+        errorPrint("epoll_ctl() failed, reason: %s\n", strerror(errno));
+        return -1;
+    }
+    conn->wantWrite = wantWrite;
+    return 0;
+}
+
+static int32_t restReconnect(SBenchRest *rest, SBenchRestConn *conn);
+
+// write as much of the queued requests as the socket takes, the rest is
+// picked up again when epoll reports the connection writable
+static int32_t restFlush(SBenchRest *rest, SBenchRestConn *conn) {
+    while (conn->written < conn->count) {
+        SBenchRestReq *req = restAt(rest, conn, conn->written);
+        struct iovec   iov[2];
+        int            iovcnt = 0;
+        uint64_t       off = req->sent;
+        if (off < req->headLen) {
+            iov[iovcnt].iov_base = req->head + off;
+            iov[iovcnt].iov_len = req->headLen - off;
+            iovcnt++;
+            off = 0;
+        } else {
+            off -= req->headLen;
+        }
+        if (off < req->bodyLen) {
+            iov[iovcnt].iov_base = req->body + off;
+            iov[iovcnt].iov_len = req->bodyLen - off;
+            iovcnt++;
+        }
+        struct msghdr msg = {0};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt;
+        ssize_t bytes = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return restWatch(rest, conn, true);
+            }
+            if (errno == EPIPE || errno == ECONNRESET) {
+                return restReconnect(rest, conn);
+            }
+            errorPrint("failed to send REST request, reason: %s\n",
+                       strerror(errno));
+            return -1;
+        }
+        req->sent += bytes;
+        if (req->sent == req->headLen + req->bodyLen) {
+            conn->written++;
+        }
+    }
+    return restWatch(rest, conn, false);
+}
+
+static int32_t restQueue(SBenchRest *rest, SBenchRestConn *conn,
+                         int32_t idx) {
+    conn->ring[(conn->head + conn->count) % rest->depth] = idx;
+    conn->count++;
+    return restFlush(rest, conn);
+}
+
+static SBenchRestConn *restLeastLoaded(SBenchRest *rest) {
+    SBenchRestConn *conn = rest->conns;
+    for (int32_t i = 1; i < rest->nconn; i++) {
+        if (rest->conns[i].count < conn->count) {
+            conn = rest->conns + i;
+        }
+    }
+    return conn;
+}
+
+static int32_t restOpen(SBenchRest *rest, SBenchRestConn *conn) {
+    conn->fd = createSockFd();
+    if (conn->fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(conn->fd, F_SETFL, fcntl(conn->fd, F_GETFL, 0) | O_NONBLOCK);
+
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.ptr = conn;
+    if (epoll_ctl(rest->epfd, EPOLL_CTL_ADD, conn->fd, &ev)) {
+        errorPrint("epoll_ctl() failed, reason: %s\n", strerror(errno));
+        return -1;
+    }
+    conn->wantWrite = false;
+    return 0;
+}
+
+// the server closed the connection, e.g. when keep-alive timed out: open
+// a new one and send the requests not answered yet again from the start
+static int32_t restReconnect(SBenchRest *rest, SBenchRestConn *conn) {
+    if (conn->count > 0 && ++conn->reconnects > REST_MAX_RECONNECTS) {
+        errorPrint("REST connection closed by server %d times without "
+                   "a response\n", REST_MAX_RECONNECTS);
+        return -1;
+    }
+    debugPrint("REST connection closed by server, reconnecting with %d "
+               "request(s) in flight\n", conn->count);
+    // closing the socket also removes it from epoll
+    destroySockFd(conn->fd);
+    conn->fd = -1;
+    conn->resp.end = 0;
+    benchHttpNext(&conn->resp);
+    if (restOpen(rest, conn)) {
+        return -1;
+    }
+    for (int32_t i = 0; i < conn->count; i++) {
+        restAt(rest, conn, i)->sent = 0;
+    }
+    conn->written = 0;
+    return restFlush(rest, conn);
+}
+
+// send the failed requests whose retry interval passed again, *waitMs is
+// the time until the next one is due, -1 when none is waiting
+static int32_t restResend(SBenchRest *rest, int *waitMs) {
+    int64_t now = benchGetMonotonicUs();
+    int64_t next = -1;
+    for (int32_t i = 0; i < rest->retryCount;) {
+        int32_t        idx = rest->retryReqs[i];
+        SBenchRestReq *req = rest->reqs + idx;
+        if (req->retryUs > now) {
+            int64_t ms = (req->retryUs - now + 999) / 1000;
+            if (next < 0 || ms < next) {
+                next = ms;
+            }
+            i++;
+            continue;
+        }
+        rest->retryReqs[i] = rest->retryReqs[--rest->retryCount];
+        req->sent = 0;
+        req->startTs = now;
+        if (restQueue(rest, restLeastLoaded(rest), idx)) {
+            return -1;
+        }
+    }
+    *waitMs = (int)next;
+    return 0;
+}
+
+// account for the response at the front of the connection. a failed
+// request is sent again after the trying interval while keep trying
+// allows, the other requests keep going meanwhile
+static int32_t restComplete(SBenchRest *rest, SBenchRestConn *conn) {
+    if (conn->written == 0) {
+        errorPrint("%s", "unexpected REST response before request was sent\n");
+        return -1;
+    }
+    int32_t        idx = conn->ring[conn->head];
+    SBenchRestReq *req = rest->reqs + idx;
+    int64_t        endTs = benchGetMonotonicUs();
+    int32_t        code = benchRestCheckResp(&conn->resp, rest->iface,
+                                             rest->protocol);
+    conn->head = (conn->head + 1) % rest->depth;
+    conn->count--;
+    conn->written--;
+    conn->reconnects = 0;
+    rest->done(rest->param, req, code, endTs);
+
+    if (code) {
+        if (req->trying == 0) {
+            return -1;
+        }
+        if (req->trying != -1) {
+            req->trying--;
+        }
+        infoPrint("will re-insert in %"PRIu32" milliseconds\n",
+                  rest->tryingInterval);
+        req->retryUs = endTs + (int64_t)rest->tryingInterval * 1000;
+        rest->retryReqs[rest->retryCount++] = idx;
+        return 0;
+    }
+    rest->freeReqs[rest->freeCount++] = idx;
+    rest->inflight--;
+    return 0;
+}
+
+static int32_t restRead(SBenchRest *rest, SBenchRestConn *conn) {
+    SBenchHttpResp *resp = &conn->resp;
+    while (true) {
+        if (benchHttpReserve(resp, INT64_MAX)) {
+            return -1;
+        }
+        ssize_t bytes = recv(conn->fd, resp->buf + resp->len,
+                             resp->cap - resp->len, 0);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            if (errno == ECONNRESET) {
+                return restReconnect(rest, conn);
+            }
+            errorPrint("failed to read REST response, reason: %s\n",
+                       strerror(errno));
+            return -1;
+        }
+        if (bytes == 0) {
+            return restReconnect(rest, conn);
+        }
+        resp->len += bytes;
+        while (benchHttpParse(resp)) {
+            if (restComplete(rest, conn)) {
+                return -1;
+            }
+            benchHttpNext(resp);
+        }
+    }
+}
+
+static int32_t restPoll(SBenchRest *rest, int timeoutMs) {
+    int waitMs;
+    if (restResend(rest, &waitMs)) {
+        return -1;
+    }
+    if (waitMs >= 0 && (timeoutMs < 0 || waitMs < timeoutMs)) {
+        timeoutMs = waitMs;
+    }
+    struct epoll_event events[REST_MAX_EVENTS];
+    int n = epoll_wait(rest->epfd, events, REST_MAX_EVENTS, timeoutMs);
+    if (n < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        errorPrint("epoll_wait() failed, reason: %s\n", strerror(errno));
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        SBenchRestConn *conn = events[i].data.ptr;
+        if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+            if (restRead(rest, conn)) {
+                return -1;
+            }
+        }
+        if (events[i].events & EPOLLOUT) {
+            if (restFlush(rest, conn)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+SBenchRest *benchRestInit(int32_t nconn, int32_t depth, char *dbName,
+                          int precision, int iface, int protocol,
+                          uint16_t port, int32_t trying,
+                          uint32_t tryingInterval,
+                          BenchRestDone done, void *param) {
+    SBenchRest *rest = benchCalloc(1, sizeof(SBenchRest), true);
+    rest->nconn = nconn;
+    rest->depth = depth > 0 ? depth : 1;
+    rest->iface = iface;
+    rest->protocol = protocol;
+    rest->port = port;
+    rest->trying = trying;
+    rest->tryingInterval = tryingInterval;
+    rest->done = done;
+    rest->param = param;
+    benchRestUrl(rest->url, dbName, precision, iface, protocol);
+
+    int32_t slots = rest->nconn * rest->depth;
+    rest->reqs = benchCalloc(slots, sizeof(SBenchRestReq), true);
+    rest->freeReqs = benchCalloc(slots, sizeof(int32_t), true);
+    rest->retryReqs = benchCalloc(slots, sizeof(int32_t), true);
+    for (int32_t i = 0; i < slots; i++) {
+        rest->freeReqs[rest->freeCount++] = slots - 1 - i;
+    }
+    rest->conns = benchCalloc(nconn, sizeof(SBenchRestConn), true);
+    for (int32_t i = 0; i < nconn; i++) {
+        rest->conns[i].fd = -1;
+    }
+
+    rest->epfd = epoll_create1(0);
+    if (rest->epfd < 0) {
+        errorPrint("epoll_create1() failed, reason: %s\n", strerror(errno));
+        benchRestDestroy(rest);
+        return NULL;
+    }
+    for (int32_t i = 0; i < nconn; i++) {
+        SBenchRestConn *conn = rest->conns + i;
+        conn->ring = benchCalloc(rest->depth, sizeof(int32_t), true);
+        benchHttpNext(&conn->resp);
+        if (restOpen(rest, conn)) {
+            benchRestDestroy(rest);
+            return NULL;
+        }
+    }
+    return rest;
+}
+
+// queue one request on the least loaded connection, waiting for a free
+// slot when all connections already carry depth requests
+int32_t benchRestSubmit(SBenchRest *rest, const char *body, uint64_t len,
+                        int64_t rows, int64_t intendedTs) {
+    while (!rest->failed && rest->freeCount == 0) {
+        if (restPoll(rest, -1)) {
+            rest->failed = true;
+        }
+    }
+    if (rest->failed) {
+        return -1;
+    }
+
+    int32_t        idx = rest->freeReqs[--rest->freeCount];
+    SBenchRestReq *req = rest->reqs + idx;
+    const char *   encoding = benchHttpEncoding();
+    if (encoding) {
+        // compress ahead straight into the slot while others are in flight
+        int64_t zlen = benchHttpCompress(body, len,
+                                         &req->body, &req->bodyCap);
+        if (zlen < 0) {
+            rest->freeReqs[rest->freeCount++] = idx;
+            rest->failed = true;
+            return -1;
+        }
+        req->bodyLen = (uint64_t)zlen;
+    } else {
+        if (req->bodyCap < len + 1) {
+            tmfree(req->body);
+            req->bodyCap = len + 1;
+            req->body = benchCalloc(1, req->bodyCap, false);
+        }
+        memcpy(req->body, body, len);
+        req->bodyLen = len;
+    }
+    req->rawLen = len;
+    req->headLen = benchHttpHeader(req->head, sizeof(req->head),
+                                   rest->url, rest->port, req->bodyLen,
+                                   encoding);
+    req->sent = 0;
+    req->rows = rows;
+    req->intendedTs = intendedTs;
+    req->trying = rest->trying;
+    req->startTs = benchGetMonotonicUs();
+    rest->inflight++;
+
+    SBenchRestConn *conn = restLeastLoaded(rest);
+    // harvest whatever already completed so latency is not inflated by
+    // the time spent generating the next batch
+    if (restQueue(rest, conn, idx) || restPoll(rest, 0)) {
+        rest->failed = true;
+        return -1;
+    }
+    return 0;
+}
+
+int32_t benchRestDrain(SBenchRest *rest) {
+    while (!rest->failed && rest->inflight > 0) {
+        if (restPoll(rest, -1)) {
+            rest->failed = true;
+        }
+    }
+    return rest->failed ? -1 : 0;
+}
+
+void benchRestDestroy(SBenchRest *rest) {
+    if (NULL == rest) {
+        return;
+    }
+    for (int32_t i = 0; rest->conns && i < rest->nconn; i++) {
+        SBenchRestConn *conn = rest->conns + i;
+        if (conn->fd >= 0) {
+            destroySockFd(conn->fd);
+        }
+        tmfree(conn->ring);
+        benchHttpFree(&conn->resp);
+    }
+    for (int32_t i = 0; rest->reqs && i < rest->nconn * rest->depth; i++) {
+        tmfree(rest->reqs[i].body);
+    }
+    if (rest->epfd >= 0) {
+        close(rest->epfd);
+    }
+    tmfree(rest->conns);
+    tmfree(rest->reqs);
+    tmfree(rest->freeReqs);
+    tmfree(rest->retryReqs);
+    tmfree(rest);
+}
+
+#else
+
+SBenchRest *benchRestInit(int32_t nconn, int32_t depth, char *dbName,
+                          int precision, int iface, int protocol,
+                          uint16_t port, int32_t trying,
+                          uint32_t tryingInterval,
+                          BenchRestDone done, void *param) {
+    errorPrint("%s", "rest_connections is only supported on Linux\n");
+    return NULL;
+}
+
+int32_t benchRestSubmit(SBenchRest *rest, const char *body, uint64_t len,
+                        int64_t rows, int64_t intendedTs) {
+    return -1;
+}
+
+int32_t benchRestDrain(SBenchRest *rest) {
+    return 0;
+}
+
+void benchRestDestroy(SBenchRest *rest) {}
+
+#endif
@@ -42,7 +42,7 @@ static TAOS_SUB *subscribeImpl(QUERY_CLASS class, threadInfo *pThreadInfo,
                                uint64_t interval) {
     TAOS_SUB *tsub = NULL;
 
-    if (taos_select_db(pThreadInfo->conn->taos, g_queryInfo.dbName)) {
+    if (benchSelectDb(pThreadInfo->conn, g_queryInfo.dbName)) {
         errorPrint("failed to select database(%s)\n", g_queryInfo.dbName);
         return NULL;
     }
@@ -37,6 +37,7 @@ void benchPrintHelp() {
     printf("%s%s%s%s\r\n", indent, "-h,", indent, BENCH_HOST);
     printf("%s%s%s%s\r\n", indent, "-i,", indent, BENCH_INTERVAL);
     printf("%s%s%s%s\r\n", indent, "-I,", indent, BENCH_MODE);
+    printf("%s%s%s%s\r\n", indent, "-j,", indent, BENCH_REPORT_INTERVAL);
     printf("%s%s%s%s\r\n", indent, "-l,", indent, BENCH_COLS_NUM);
     printf("%s%s%s%s\r\n", indent, "-L,", indent, BENCH_PARTIAL_COL_NUM);
     printf("%s%s%s%s\r\n", indent, "-m,", indent, BENCH_PREFIX);
@@ -44,10 +45,12 @@ void benchPrintHelp() {
     printf("%s%s%s%s\r\n", indent, "-n,", indent, BENCH_ROWS);
     printf("%s%s%s%s\r\n", indent, "-N,", indent, BENCH_NORMAL);
     printf("%s%s%s%s\r\n", indent, "-k,", indent, BENCH_KEEPTRYING);
+    printf("%s%s%s%s\r\n", indent, "-K,", indent, BENCH_AFFINITY);
     printf("%s%s%s%s\r\n", indent, "-o,", indent, BENCH_OUTPUT);
     printf("%s%s%s%s\r\n", indent, "-O,", indent, BENCH_DISORDER);
     printf("%s%s%s%s\r\n", indent, "-p,", indent, BENCH_PASS);
     printf("%s%s%s%s\r\n", indent, "-P,", indent, BENCH_PORT);
+    printf("%s%s%s%s\r\n", indent, "-Q,", indent, BENCH_TARGET_RATE);
     printf("%s%s%s%s\r\n", indent, "-r,", indent, BENCH_BATCH);
     printf("%s%s%s%s\r\n", indent, "-R,", indent, BENCH_RANGE);
     printf("%s%s%s%s\r\n", indent, "-S,", indent, BENCH_STEP);
@@ -58,8 +61,10 @@ void benchPrintHelp() {
     printf("%s%s%s%s\r\n", indent, "-U,", indent, BENCH_SUPPLEMENT);
     printf("%s%s%s%s\r\n", indent, "-w,", indent, BENCH_WIDTH);
     printf("%s%s%s%s\r\n", indent, "-x,", indent, BENCH_AGGR);
+    printf("%s%s%s%s\r\n", indent, "-X,", indent, BENCH_RANDOM_SEED);
     printf("%s%s%s%s\r\n", indent, "-y,", indent, BENCH_YES);
     printf("%s%s%s%s\r\n", indent, "-z,", indent, BENCH_TRYING_INTERVAL);
+    printf("%s%s%s%s\r\n", indent, "-Z,", indent, BENCH_PROCESSES);
 #ifdef WEBSOCKET
     printf("%s%s%s%s\r\n", indent, "-W,", indent, BENCH_DSN);
     printf("%s%s%s%s\r\n", indent, "-D,", indent, BENCH_TIMEOUT);
@@ -109,6 +114,9 @@ int32_t benchParseArgsNoArgp(int argc, char* argv[]) {
             || key[1] == 'R' || key[1] == 'O'
             || key[1] == 'a' || key[1] == 'F'
             || key[1] == 'k' || key[1] == 'z'
+            || key[1] == 'X' || key[1] == 'j'
+            || key[1] == 'Q' || key[1] == 'Z'
+            || key[1] == 'K'
 #ifdef WEBSOCKET
             || key[1] == 'D' || key[1] == 'W'
 #endif
@@ -16,6 +16,7 @@ typedef struct {
     tmq_t* tmq;
     int    rows;
     int    id;
+    SBenchHist* delayHist;
 } tmqThreadInfo;
 
 static int create_topic(BArray* sqls) {
@@ -24,10 +25,7 @@ static int create_topic(BArray* sqls) {
         return -1;
     }
     TAOS* taos = conn->taos;
-    char command[SQL_BUFF_LEN];
-    memset(command, 0, SQL_BUFF_LEN);
-    sprintf(command, "use %s", g_queryInfo.dbName);
-    if (queryDbExec(conn, command)) {
+    if (benchSelectDb(conn, g_queryInfo.dbName)) {
         close_bench_conn(conn);
         return -1;
     }
@@ -71,9 +69,12 @@ static void* tmqConsume(void* arg) {
     while(!g_arguments->terminate
         && subscribeTimes > 0) {
         debugPrint("%s", "tmq_consumer_poll()");
+        int64_t pollStart = benchGetMonotonicUs();
         TAOS_RES * tmqMessage = tmq_consumer_poll(
                 pThreadInfo->tmq, g_queryInfo.specifiedQueryInfo.queryInterval);
         if (tmqMessage != NULL) {
+            benchHistRecord(pThreadInfo->delayHist,
+                            benchGetMonotonicUs() - pollStart);
             if (first_time) {
                 st = toolsGetTimestampUs();
                 first_time = false;
@@ -129,6 +130,7 @@ int subscribeTestProcess() {
         tmqThreadInfo * pThreadInfo = infos + i;
         pThreadInfo->rows = 0;
         pThreadInfo->id = i;
+        pThreadInfo->delayHist = benchHistInit();
         tmq_conf_t * conf = tmq_conf_new();
         char groupid[BIGINT_BUFF_LEN];
         memset(groupid, 0, BIGINT_BUFF_LEN);
@@ -155,11 +157,29 @@ int subscribeTestProcess() {
         pthread_create(pids + i, NULL, tmqConsume, pThreadInfo);
     }
 
+    SBenchHist *hist = benchHistInit();
     for (int i = 0; i < g_queryInfo.specifiedQueryInfo.concurrent; i++) {
         pthread_join(pids[i], NULL);
+        benchHistMerge(hist, infos[i].delayHist);
     }
+    if (hist->count) {
+        infoPrint("consume %"PRIu64" messages, poll delay "
+                  "min: %.6fs, avg: %.6fs, p50: %.6fs, p90: %.6fs, "
+                  "p99: %.6fs, p99.9: %.6fs, p99.99: %.6fs, max: %.6fs\n",
+                  hist->count, hist->min/1E6, benchHistMean(hist)/1E6,
+                  benchHistPercentile(hist, 50)/1E6,
+                  benchHistPercentile(hist, 90)/1E6,
+                  benchHistPercentile(hist, 99)/1E6,
+                  benchHistPercentile(hist, 99.9)/1E6,
+                  benchHistPercentile(hist, 99.99)/1E6,
+                  hist->max/1E6);
+    }
+    benchHistDestroy(hist);
 
 tmq_over:
+    for (int i = 0; i < g_queryInfo.specifiedQueryInfo.concurrent; i++) {
+        benchHistDestroy(infos[i].delayHist);
+    }
     free(pids);
     free(infos);
     tmq_list_destroy(topic_list);
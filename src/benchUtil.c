@@ -12,12 +12,7 @@
 
 #include "bench.h"
 
-char resEncodingChunk[] = "Encoding: chunked";
 char succMessage[] = "succ";
-char resHttp[] = "HTTP/1.1 ";
-char resHttpOk[] = "HTTP/1.1 200 OK";
-char influxHttpOk[] = "HTTP/1.1 204";
-char opentsdbHttpOk[] = "HTTP/1.1 400";
 
 FORCE_INLINE void* benchCalloc(size_t nmemb, size_t size, bool record) {
     void* ret = calloc(nmemb, size);
@@ -98,12 +93,6 @@ void resetAfterAnsiEscape(void) {
     }
 }
 
-unsigned int taosRandom() {
-    unsigned int number;
-    rand_s(&number);
-
-    return number;
-}
 #else  // Not windows
 void setupForAnsiEscape(void) {}
 
@@ -111,10 +100,80 @@ void resetAfterAnsiEscape(void) {
     // Reset colors
     printf("\x1b[0m");
 }
-
-FORCE_INLINE unsigned int taosRandom() { return (unsigned int)rand(); }
 #endif
 
+static BENCH_THREAD_LOCAL SBenchRand *g_threadRand = NULL;
+static BENCH_THREAD_LOCAL SBenchRand  g_defaultRand;
+static BENCH_THREAD_LOCAL bool        g_defaultRandSeeded = false;
+// threads that never bind a generator draw from the default stream they
+// named with benchRandSetStream(), 0 for the main thread
+static BENCH_THREAD_LOCAL uint64_t    g_defaultRandStream = 0;
+
+static FORCE_INLINE uint64_t benchRotl(const uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t benchSplitMix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// derive an independent sequence for each stream (thread) from one seed
+void benchRandSeed(SBenchRand *r, uint64_t seed, uint64_t stream) {
+    uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++) {
+        r->s[i] = benchSplitMix64(&x);
+    }
+}
+
+// make taosRandom() in the calling thread draw from r, returns the
+// previous binding so a short detour can restore it
+SBenchRand *benchRandBind(SBenchRand *r) {
+    SBenchRand *prev = g_threadRand;
+    g_threadRand = r;
+    return prev;
+}
+
+// name the default stream of the calling thread by a stable id such as
+// its thread index, so what it draws does not depend on thread start order
+void benchRandSetStream(uint64_t stream) {
+    g_defaultRandStream = stream;
+    g_defaultRandSeeded = false;
+    if (g_threadRand == &g_defaultRand) {
+        g_threadRand = NULL;
+    }
+}
+
+FORCE_INLINE uint64_t benchRandNext(SBenchRand *r) {
+    uint64_t *s = r->s;
+    const uint64_t result = benchRotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = benchRotl(s[3], 45);
+
+    return result;
+}
+
+unsigned int taosRandom() {
+    if (NULL == g_threadRand) {
+        if (!g_defaultRandSeeded) {
+            benchRandSeed(&g_defaultRand, g_arguments->random_seed,
+                          ((uint64_t)3 << 32) + g_defaultRandStream);
+            g_defaultRandSeeded = true;
+        }
+        g_threadRand = &g_defaultRand;
+    }
+    // 31 bits, the same range glibc rand() used to return
+    return (unsigned int)(benchRandNext(g_threadRand) >> 33);
+}
+
 int getAllChildNameOfSuperTable(TAOS *taos, char *dbName, char *stbName,
         char ** childTblNameOfSuperTbl,
         int64_t childTblCountOfSuperTbl) {
@@ -279,7 +338,15 @@ int regexMatch(const char *s, const char *reg, int cflags) {
     return 0;
 }
 
-SBenchConn* init_bench_conn() {
+// Connections are kept for the whole process: every phase (table
+// creation, insert, query, the slow query killer) takes one from the
+// idle list and puts it back, so the handshake is paid once per
+// connection instead of once per phase.
+static pthread_mutex_t g_connPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static SBenchConn *    g_connPool;
+static int32_t         g_connPoolIdle;
+
+static SBenchConn* connectBench() {
     SBenchConn* conn = benchCalloc(1, sizeof(SBenchConn), true);
 #ifdef WEBSOCKET
     if (g_arguments->websocket) {
@@ -307,12 +374,56 @@ SBenchConn* init_bench_conn() {
     return conn;
 }
 
+SBenchConn* init_bench_conn() {
+    pthread_mutex_lock(&g_connPoolLock);
+    SBenchConn* conn = g_connPool;
+    if (conn) {
+        g_connPool = conn->next;
+        g_connPoolIdle--;
+        conn->next = NULL;
+    }
+    pthread_mutex_unlock(&g_connPoolLock);
+    if (conn) {
+        return conn;
+    }
+    return connectBench();
+}
+
+// give the connection back to the pool, the selected database is kept
 void close_bench_conn(SBenchConn* conn) {
+    if (NULL == conn) {
+        return;
+    }
+#ifdef WEBSOCKET
+    if (conn->stmt_ws) {
+        ws_stmt_close(conn->stmt_ws);
+        conn->stmt_ws = NULL;
+    }
+#endif
+    if (conn->stmt) {
+        taos_stmt_close(conn->stmt);
+        conn->stmt = NULL;
+    }
+    pthread_mutex_lock(&g_connPoolLock);
+    conn->next = g_connPool;
+    g_connPool = conn;
+    g_connPoolIdle++;
+    pthread_mutex_unlock(&g_connPoolLock);
+}
+
+// really disconnect, for connections that must not be reused
+void drop_bench_conn(SBenchConn* conn) {
+    if (NULL == conn) {
+        return;
+    }
 #ifdef WEBSOCKET
     if (g_arguments->websocket) {
         ws_close(conn->taos_ws);
     } else {
 #endif
+        if (conn->stmt) {
+            taos_stmt_close(conn->stmt);
+        }
         taos_close(conn->taos);
 #ifdef WEBSOCKET
     }
@@ -320,9 +431,73 @@ void close_bench_conn(SBenchConn* conn) {
     tmfree(conn);
 }
 
+// open connections up front so that no benchmark phase measures the
+// connection setup, returns the number of idle connections afterwards
+int32_t benchConnPoolWarmup(int32_t count) {
+    pthread_mutex_lock(&g_connPoolLock);
+    int32_t need = count - g_connPoolIdle;
+    pthread_mutex_unlock(&g_connPoolLock);
+    int64_t start = toolsGetTimestampMs();
+    int32_t opened = 0;
+    for (; opened < need; opened++) {
+        SBenchConn *conn = connectBench();
+        if (NULL == conn) {
+            break;
+        }
+        close_bench_conn(conn);
+    }
+    if (opened > 0) {
+        infoPrint("opened %d connections in %.3f seconds\n", opened,
+                  (toolsGetTimestampMs() - start) / 1000.0);
+    }
+    pthread_mutex_lock(&g_connPoolLock);
+    int32_t idle = g_connPoolIdle;
+    pthread_mutex_unlock(&g_connPoolLock);
+    return idle;
+}
+
+void benchConnPoolDestroy() {
+    pthread_mutex_lock(&g_connPoolLock);
+    SBenchConn *conn = g_connPool;
+    g_connPool = NULL;
+    g_connPoolIdle = 0;
+    pthread_mutex_unlock(&g_connPoolLock);
+    while (conn) {
+        SBenchConn *next = conn->next;
+        drop_bench_conn(conn);
+        conn = next;
+    }
+}
+
+// switch the connection to dbName unless it is already there
+int32_t benchSelectDb(SBenchConn *conn, const char *dbName) {
+    if (0 == strcmp(conn->db, dbName)) {
+        return 0;
+    }
+    int32_t code;
+#ifdef WEBSOCKET
+    if (g_arguments->websocket) {
+        char command[SQL_BUFF_LEN];
+        snprintf(command, SQL_BUFF_LEN, "USE %s", dbName);
+        code = queryDbExec(conn, command);
+    } else {
+#endif
+        code = taos_select_db(conn->taos, dbName);
+#ifdef WEBSOCKET
+    }
+#endif
+    if (code) {
+        conn->db[0] = '\0';
+        return code;
+    }
+    tstrncpy(conn->db, dbName, TSDB_DB_NAME_LEN);
+    return 0;
+}
+
 int32_t queryDbExecRest(char *command, char* dbName, int precision,
                     int iface, int protocol, bool tcp, int sockfd) {
     int32_t code = postProceSql(command,
+                         strlen(command),
                          dbName,
                          precision,
                          iface,
@@ -398,15 +573,9 @@ void encodeAuthBase64() {
         g_arguments->base64_buf[encoded_len - 1 - l] = '=';
 }
 
-int postProceSqlImpl(char *sqlstr, char* dbName, int precision, int iface,
-                     int protocol, uint16_t rest_port, bool tcp, int sockfd, char* filePath,
-                     char *responseBuf, int64_t response_length) {
-    int32_t      code = -1;
-    char *       req_fmt =
-        "POST %s HTTP/1.1\r\nHost: %s:%d\r\nAccept: */*\r\nAuthorization: "
-        "Basic %s\r\nContent-Length: %d\r\nContent-Type: "
-        "application/x-www-form-urlencoded\r\n\r\n%s";
-    char url[1024];
+void benchRestUrl(char *url, char* dbName, int precision, int iface,
+                  int protocol) {
+    url[0] = '\0';
     if (iface == REST_IFACE) {
         sprintf(url, "/rest/sql/%s", dbName);
     } else if (iface == SML_REST_IFACE &&
@@ -424,119 +593,41 @@ int postProceSqlImpl(char *sqlstr, char* dbName, int precision, int iface,
             && protocol == TSDB_SML_JSON_PROTOCOL) {
         sprintf(url, "/opentsdb/v1/put/json/%s", dbName);
     }
+}
 
-    int      bytes, sent, received, req_str_len, resp_len;
-    char *   request_buf = NULL;
-    int req_buf_len = (int)strlen(sqlstr) + REQ_EXTRA_BUF_LEN;
-
-    request_buf = benchCalloc(1, req_buf_len, false);
-
-    int r;
+static int postProceSqlImpl(char *sqlstr, uint64_t len, char* dbName,
+                            int precision, int iface, int protocol,
+                            uint16_t rest_port, bool tcp, int sockfd,
+                            char* filePath, uint64_t response_length,
+                            SBenchHttpResp **pResp) {
+    *pResp = NULL;
     if (protocol == TSDB_SML_TELNET_PROTOCOL && tcp) {
-        r = snprintf(request_buf, req_buf_len, "%s", sqlstr);
-    } else {
-        r = snprintf(request_buf, req_buf_len, req_fmt, url, g_arguments->host,
-                rest_port, g_arguments->base64_buf, strlen(sqlstr),
-                sqlstr);
-    }
-    if (r >= req_buf_len) {
-        free(request_buf);
-        ERROR_EXIT("too long request");
+        debugPrint("request buffer: %s\n", sqlstr);
+        return benchHttpSend(sockfd, sqlstr, len);
     }
 
-    req_str_len = (int)strlen(request_buf);
-    debugPrint("request buffer: %s\n", request_buf);
-    sent = 0;
-    do {
-        bytes = send(sockfd, request_buf + sent,
-                req_str_len - sent, 0);
-        if (bytes < 0) {
-            errorPrint("%s", "writing no message to socket\n");
-            goto free_of_postImpl;
-        }
-        if (bytes == 0) break;
-        sent += bytes;
-    } while (sent < req_str_len);
-
-    if (protocol == TSDB_SML_TELNET_PROTOCOL && iface == SML_REST_IFACE && tcp) {
-        code = 0;
-        goto free_of_postImpl;
-    }
-
-    resp_len = response_length - 1;
-    received = 0;
-
-    bool chunked = false;
-
-    do {
-        bytes = recv(sockfd, responseBuf + received,
-                resp_len - received, 0);
-        debugPrint("response buffer: %s\n", responseBuf);
-        if (NULL != strstr(responseBuf, resEncodingChunk)) {
-            chunked = true;
-        }
-        int64_t index = strlen(responseBuf) - 1;
-        while (responseBuf[index] == '\n' || responseBuf[index] == '\r') {
-            index--;
-        }
-        debugPrint("index: %" PRId64 "\n", index);
-        if (chunked && responseBuf[index] == '0') {
-            code = 0;
-            break;
-        }
-        if (!chunked && responseBuf[index] == '}') {
-            code = 0;
-            break;
-        }
-
-        if (bytes <= 0) {
-            errorPrint("%s", "reading no response from socket\n");
-            goto free_of_postImpl;
-        }
-
-        received += bytes;
-
-        if (g_arguments->test_mode == INSERT_TEST) {
-            if (strlen(responseBuf)) {
-                if (((NULL != strstr(responseBuf, resEncodingChunk)) &&
-                            (NULL != strstr(responseBuf, resHttp))) ||
-                        ((NULL != strstr(responseBuf, resHttpOk)) ||
-                         (NULL != strstr(responseBuf, influxHttpOk)) ||
-                         (NULL != strstr(responseBuf, opentsdbHttpOk)))) {
-                    break;
-                }
-            }
-        }
-    } while (received < resp_len);
-
-    if (received == resp_len) {
-        errorPrint("%s", "storing complete response from socket\n");
-        goto free_of_postImpl;
-    }
-
-    if (NULL == strstr(responseBuf, resHttpOk) &&
-            NULL == strstr(responseBuf, influxHttpOk) &&
-            NULL == strstr(responseBuf, succMessage) &&
-            NULL == strstr(responseBuf, opentsdbHttpOk)) {
-        errorPrint("Response:\n%s\n", responseBuf);
-        goto free_of_postImpl;
+    char url[1024];
+    benchRestUrl(url, dbName, precision, iface, protocol);
+    debugPrint("request body: %s\n", sqlstr);
+    SBenchHttpResp *resp = benchHttpPost(sockfd, url, rest_port,
+                                         sqlstr, len, response_length);
+    if (NULL == resp) {
+        return -1;
     }
-
-    code = 0;
-free_of_postImpl:
     if (filePath && strlen(filePath) > 0) {
-        appendResultBufToFile(responseBuf, filePath);
+        appendResultBufToFile(resp->buf, filePath);
     }
-    tmfree(request_buf);
-    return code;
+    *pResp = resp;
+    return 0;
 }
 
 static int getServerVersionRestImpl(int16_t rest_port, int sockfd) {
     int server_ver = -1;
     char       command[SQL_BUFF_LEN] = "\0";
     sprintf(command, "SELECT SERVER_VERSION()");
-    char *responseBuf = benchCalloc(1, RESP_BUF_LEN, false);
+    SBenchHttpResp *resp = NULL;
     int code = postProceSqlImpl(command,
+                                strlen(command),
                                 NULL,
                                 0,
                                 REST_IFACE,
@@ -544,16 +635,15 @@ static int getServerVersionRestImpl(int16_t rest_port, int sockfd) {
                                 rest_port,
                                 false,
                                 sockfd,
-                                NULL, responseBuf, RESP_BUF_LEN);
+                                NULL, RESP_BUF_LEN, &resp);
     if (code != 0) {
         errorPrint("Failed to execute command: %s\n", command);
         goto free_of_getversion;
     }
-    debugPrint("response buffer: %s\n", responseBuf);
-    if (NULL != strstr(responseBuf, resHttpOk)) {
-        char* start = strstr(responseBuf, "{");
+    if (200 == resp->status) {
+        char* start = strstr(resp->body, "{");
         if (start == NULL) {
-            errorPrint("Invalid response format: %s\n", responseBuf);
+            errorPrint("Invalid response format: %s\n", resp->body);
             goto free_of_getversion;
         }
         tools_cJSON* resObj = tools_cJSON_Parse(start);
@@ -576,7 +666,6 @@ static int getServerVersionRestImpl(int16_t rest_port, int sockfd) {
         tools_cJSON_Delete(resObj);
     }
 free_of_getversion:
-    free(responseBuf);
     return server_ver;
 }
 
@@ -629,8 +718,9 @@ static int getCodeFromResp(char *responseBuf) {
     return code;
 }
 
-int postProceSql(char *sqlstr, char* dbName, int precision, int iface,
-                 int protocol, uint16_t rest_port,
+// len is the length of sqlstr, the insert paths know it already
+int postProceSql(char *sqlstr, uint64_t len, char* dbName, int precision,
+                 int iface, int protocol, uint16_t rest_port,
                  bool tcp, int sockfd, char* filePath) {
     uint64_t response_length;
     if (g_arguments->test_mode == INSERT_TEST) {
@@ -639,49 +729,59 @@ int postProceSql(char *sqlstr, char* dbName, int precision, int iface,
         response_length = g_queryInfo.response_buffer;
     }
 
-    char *responseBuf = benchCalloc(1, response_length, false);
-    int code = postProceSqlImpl(sqlstr, dbName, precision, iface, protocol,
-                                rest_port,
-                                tcp, sockfd, filePath, responseBuf,
-                                response_length);
-    if (NULL != strstr(responseBuf, resHttpOk) && iface == REST_IFACE) {
+    SBenchHttpResp *resp = NULL;
+    int code = postProceSqlImpl(sqlstr, len, dbName, precision, iface,
+                                protocol,
+                                rest_port, tcp, sockfd, filePath,
+                                response_length, &resp);
+    if (code || NULL == resp) {
+        return code;
+    }
+    return benchRestCheckResp(resp, iface, protocol);
+}
+
+int32_t benchRestCheckResp(SBenchHttpResp *resp, int iface, int protocol) {
+    int32_t code = 0;
+    char *body = resp->body;
+
+    if (200 == resp->status && iface == REST_IFACE) {
         if (3 <= g_arguments->rest_server_ver_major) {
-            code = getCodeFromResp(responseBuf);
-        } else {
-            code = 0;
+            return getCodeFromResp(body);
         }
-        goto free_of_post;
+        return 0;
     }
 
     if (2 == g_arguments->rest_server_ver_major) {
-        if (NULL != strstr(responseBuf, succMessage) && iface == REST_IFACE) {
-            code = getCodeFromResp(responseBuf);
-        } else {
-            code = 0;
+        if (NULL != strstr(body, succMessage) && iface == REST_IFACE) {
+            return getCodeFromResp(body);
         }
-        goto free_of_post;
+        return 0;
     }
 
-    if (NULL != strstr(responseBuf, influxHttpOk) &&
+    if (204 == resp->status &&
             protocol == TSDB_SML_LINE_PROTOCOL && iface == SML_REST_IFACE) {
-        code = 0;
-        goto free_of_post;
+        return 0;
     }
 
-    if (NULL != strstr(responseBuf, opentsdbHttpOk)
+    if (400 == resp->status
             && (protocol == TSDB_SML_TELNET_PROTOCOL
             || protocol == TSDB_SML_JSON_PROTOCOL)
             && iface == SML_REST_IFACE) {
-        code = 0;
-        goto free_of_post;
+        return 0;
+    }
+
+    if (200 != resp->status && 204 != resp->status && 400 != resp->status
+            && NULL == strstr(body, succMessage)) {
+        errorPrint("Response:\n%s\n", resp->buf);
+        return -1;
     }
 
     if (g_arguments->test_mode == INSERT_TEST) {
-        debugPrint("Response: \n%s\n", responseBuf);
-        char* start = strstr(responseBuf, "{");
+        debugPrint("Response: \n%s\n", resp->buf);
+        char* start = strstr(body, "{");
         if (start == NULL) {
-            errorPrint("Invalid response format: %s\n", responseBuf);
-            goto free_of_post;
+            errorPrint("Invalid response format: %s\n", body);
+            return code;
         }
         tools_cJSON* resObj = tools_cJSON_Parse(start);
         if (resObj == NULL) {
@@ -692,13 +792,12 @@ int postProceSql(char *sqlstr, char* dbName, int precision, int iface,
             errorPrint("Invalid or miss 'code' key in json: %s\n",
                        tools_cJSON_Print(resObj));
             tools_cJSON_Delete(resObj);
-            goto free_of_post;
+            return code;
         }
 
         if ((SML_REST_IFACE == iface) && (200 == codeObj->valueint)) {
-            code = 0;
             tools_cJSON_Delete(resObj);
-            goto free_of_post;
+            return 0;
         }
 
         if (codeObj->valueint != 0
@@ -718,8 +817,6 @@ int postProceSql(char *sqlstr, char* dbName, int precision, int iface,
         }
         tools_cJSON_Delete(resObj);
     }
-free_of_post:
-    free(responseBuf);
     return code;
 }
 
@@ -1039,6 +1136,243 @@ void* benchArrayGet(const BArray* pArray, size_t index) {
     return BARRAY_GET_ELEM(pArray, index);
 }
 
+// Strings that live as long as the arena, carved out of large chunks so
+// that millions of short names cost neither a malloc nor a fixed-size
+// slot each. Returned pointers stay valid until benchArenaDestroy().
+SBenchArena *benchArenaInit(uint64_t chunkSize) {
+    SBenchArena *arena = benchCalloc(1, sizeof(SBenchArena), true);
+    arena->chunkSize = chunkSize;
+    return arena;
+}
+
+char *benchArenaAlloc(SBenchArena *arena, uint64_t size) {
+    SBenchArenaChunk *chunk = arena->head;
+    if (NULL == chunk || chunk->used + size > chunk->cap) {
+        uint64_t cap = size > arena->chunkSize ? size : arena->chunkSize;
+        chunk = benchCalloc(1, sizeof(SBenchArenaChunk) + cap, true);
+        chunk->cap = cap;
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+    char *p = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->bytes += size;
+    return p;
+}
+
+char *benchArenaStrndup(SBenchArena *arena, const char *s, uint64_t len) {
+    char *p = benchArenaAlloc(arena, len + 1);
+    memcpy(p, s, len);
+    p[len] = '\0';
+    return p;
+}
+
+void benchArenaDestroy(SBenchArena *arena) {
+    if (NULL == arena) {
+        return;
+    }
+    SBenchArenaChunk *chunk = arena->head;
+    while (chunk) {
+        SBenchArenaChunk *next = chunk->next;
+        tmfree(chunk);
+        chunk = next;
+    }
+    tmfree(arena);
+}
+
+// place the calling worker thread, seq counts the threads of one phase
+void benchBindThread(int32_t seq) {
+    if (toolsBindThread(seq)) {
+        warnPrint("failed to set the affinity of thread %d\n", seq);
+    }
+}
+
+int64_t benchGetMonotonicUs() {
+#ifdef WINDOWS
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER        counter;
+    if (0 == freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&counter);
+    return (int64_t)(counter.QuadPart * 1000000 / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+#endif
+}
+
+// the OS sleep overshoots by tens of microseconds, so sleep until
+// close to the deadline and spin for the rest
+#define BENCH_SPIN_US 50
+
+void benchSleepUntilUs(int64_t deadline) {
+    int64_t left = deadline - benchGetMonotonicUs();
+    while (left > 0) {
+        if (left > BENCH_SPIN_US) {
+#ifdef WINDOWS
+            Sleep((DWORD)((left - BENCH_SPIN_US) / 1000));
+#else
+            struct timespec ts;
+            ts.tv_sec = (left - BENCH_SPIN_US) / 1000000;
+            ts.tv_nsec = ((left - BENCH_SPIN_US) % 1000000) * 1000;
+            nanosleep(&ts, NULL);
+#endif
+        }
+        left = deadline - benchGetMonotonicUs();
+    }
+}
+
+static FORCE_INLINE int benchHistMsb(uint64_t v) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(v);
+#else
+    int msb = 0;
+    while (v >>= 1) {
+        msb++;
+    }
+    return msb;
+#endif
+}
+
+// values below BENCH_HIST_SUB_COUNT get one bucket each, every following
+// power of two is split into BENCH_HIST_SUB_COUNT linear sub buckets
+static FORCE_INLINE int32_t benchHistIndex(int64_t value) {
+    if (value < BENCH_HIST_SUB_COUNT) {
+        return value < 0 ? 0 : (int32_t)value;
+    }
+    int msb = benchHistMsb((uint64_t)value);
+    if (msb >= BENCH_HIST_MAX_BITS) {
+        return BENCH_HIST_BUCKETS - 1;
+    }
+    int shift = msb - BENCH_HIST_SUB_BITS;
+    return (shift + 1) * BENCH_HIST_SUB_COUNT
+        + (int32_t)((value >> shift) - BENCH_HIST_SUB_COUNT);
+}
+
+static int64_t benchHistBucketValue(int32_t index) {
+    if (index < BENCH_HIST_SUB_COUNT) {
+        return index;
+    }
+    int     shift = index / BENCH_HIST_SUB_COUNT - 1;
+    int64_t sub = index % BENCH_HIST_SUB_COUNT + BENCH_HIST_SUB_COUNT;
+    // middle of the bucket
+    return (sub << shift) + ((((int64_t)1) << shift) >> 1);
+}
+
+SBenchHist* benchHistInit() {
+    SBenchHist* hist = benchCalloc(1, sizeof(SBenchHist), true);
+    benchHistReset(hist);
+    return hist;
+}
+
+void benchHistReset(SBenchHist* hist) {
+    memset(hist, 0, sizeof(SBenchHist));
+    hist->min = INT64_MAX;
+}
+
+void* benchHistDestroy(SBenchHist* hist) {
+    tmfree(hist);
+    return NULL;
+}
+
+FORCE_INLINE void benchHistRecord(SBenchHist* hist, int64_t value) {
+    hist->counts[benchHistIndex(value)]++;
+    hist->count++;
+    hist->sum += value;
+    if (value < hist->min) {
+        hist->min = value;
+    }
+    if (value > hist->max) {
+        hist->max = value;
+    }
+}
+
+void benchHistMerge(SBenchHist* dst, const SBenchHist* src) {
+    if (0 == src->count) {
+        return;
+    }
+    for (int32_t i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+// lock-free variant for a histogram sampled by another thread while its
+// owner records: counts only grow, readers take deltas with
+// benchHistMergeDelta() and min/max are left to them
+void benchHistRecordAtomic(SBenchHist* hist, int64_t value) {
+    atomic_add_fetch_64(
+            (int64_t volatile *)&hist->counts[benchHistIndex(value)], 1);
+    atomic_add_fetch_64((int64_t volatile *)&hist->count, 1);
+    atomic_add_fetch_64(&hist->sum, value);
+}
+
+// merge what cur recorded since prev into dst and move prev up to cur.
+// min and max of the interval come from its outermost buckets
+void benchHistMergeDelta(SBenchHist* dst, SBenchHist* cur, SBenchHist* prev) {
+    uint64_t count = 0;
+    for (int32_t i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        uint64_t now = (uint64_t)atomic_add_fetch_64(
+                (int64_t volatile *)&cur->counts[i], 0);
+        uint64_t delta = now - prev->counts[i];
+        if (0 == delta) {
+            continue;
+        }
+        prev->counts[i] = now;
+        dst->counts[i] += delta;
+        count += delta;
+        int64_t value = benchHistBucketValue(i);
+        if (value < dst->min) {
+            dst->min = value;
+        }
+        if (value > dst->max) {
+            dst->max = value;
+        }
+    }
+    int64_t sum = atomic_add_fetch_64(&cur->sum, 0);
+    dst->count += count;
+    dst->sum += sum - prev->sum;
+    prev->sum = sum;
+}
+
+int64_t benchHistPercentile(const SBenchHist* hist, double percentile) {
+    if (0 == hist->count) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(hist->count * percentile / 100.0 + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank >= hist->count) {
+        return hist->max;
+    }
+    uint64_t seen = 0;
+    for (int32_t i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            int64_t value = benchHistBucketValue(i);
+            if (value < hist->min) {
+                return hist->min;
+            }
+            return value > hist->max ? hist->max : value;
+        }
+    }
+    return hist->max;
+}
+
+FORCE_INLINE double benchHistMean(const SBenchHist* hist) {
+    return hist->count ? (double)hist->sum / hist->count : 0;
+}
+
 #ifdef LINUX
 int32_t bsem_wait(sem_t* sem) {
     int ret = 0;
@@ -79,6 +79,12 @@ static inline void ds_set_cap(char *s, uint64_t cap)
     s[cap] = '\0';
 }
 
+// keep the capacity so the buffer can be refilled without realloc
+void ds_clear(char *s)
+{
+    ds_set_len(s, 0);
+}
+
 char * ds_end(char *s)
 {
     return s + ds_len(s);
@@ -142,7 +148,11 @@ char * ds_resize(char **ps, size_t cap)
 
 char * ds_add_str(char **ps, const char* sub)
 {
-    size_t len = strlen(sub);
+    return ds_add_strn(ps, sub, strlen(sub));
+}
+
+char * ds_add_strn(char **ps, const char* sub, size_t len)
+{
     ds_grow(ps, len);
 
     char *s = *ps;
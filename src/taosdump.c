@@ -450,6 +450,9 @@ static struct argp_option options[] = {
     {"thread-num",  'T', "THREAD_NUM",  0,
 // DEFAULT_THREAD_NUM
         "Number of thread for dump in file. Default is 8.", 10},
+    {"affinity",  'K', "POLICY",  0,
+        "Placement of dump threads: none, compact, scatter, numa or a CPU "
+            "list such as 0-7,16-23. Default is none.", 10},
     {"loose-mode",  'L', 0,  0,
         "Use loose mode if the table name and column name use letter and "
             "number only. Default is NOT.", 10},
@@ -908,6 +911,13 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
             g_args.thread_num = atoi((const char *)arg);
             break;
 
+        case 'K':
+            if (toolsSetAffinity(arg)) {
+                errorWrongValue("taosdump", "-K", arg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+
 #ifdef WEBSOCKET
         case 'R':
             g_args.restful = true;
@@ -7217,9 +7227,17 @@ static int64_t dumpInOneAvroFile(
     return retExec;
 }
 
+static void dumpBindThread(int32_t threadIndex) {
+    if (toolsBindThread(threadIndex)) {
+        warnPrint("%s() LN%d, failed to set the affinity of thread[%d]\n",
+                  __func__, __LINE__, threadIndex);
+    }
+}
+
 static void* dumpInAvroWorkThreadFp(void *arg) {
     threadInfo *pThreadInfo = (threadInfo*)arg;
     SET_THREAD_NAME("dumpInAvroWorkThrd");
+    dumpBindThread(pThreadInfo->threadIndex);
     verbosePrint("[%d] process %"PRId64" files from %"PRId64"\n",
                     pThreadInfo->threadIndex, pThreadInfo->count,
                     pThreadInfo->from);
@@ -9932,6 +9950,7 @@ static int64_t dumpInOneDebugFile(
 static void* dumpInDebugWorkThreadFp(void *arg) {
     threadInfo *pThreadInfo = (threadInfo*)arg;
     SET_THREAD_NAME("dumpInDebugWorkThrd");
+    dumpBindThread(pThreadInfo->threadIndex);
     debugPrint2("[%d] Start to process %"PRId64" files from %"PRId64"\n",
                     pThreadInfo->threadIndex,
                     pThreadInfo->count,
@@ -10358,6 +10377,7 @@ static void dumpNormalTablesOfStbNative(
 
 static void *dumpNormalTablesOfStb(void *arg) {
     threadInfo *pThreadInfo = (threadInfo *)arg;
+    dumpBindThread(pThreadInfo->threadIndex);
 
     debugPrint("dump table from = \t%"PRId64"\n", pThreadInfo->from);
     debugPrint("dump table count = \t%"PRId64"\n", pThreadInfo->count);
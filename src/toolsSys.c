@@ -9,8 +9,11 @@
  * FITNESS FOR A PARTICULAR PURPOSE.
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 
 #ifdef WINDOWS
@@ -19,10 +22,17 @@
 #include <sysinfoapi.h>
 #else
 #include <unistd.h>
+#include <strings.h>
 #include <termios.h>
 #include <errno.h>
 #endif
 
+#ifdef LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
 #include <toolsdef.h>
 
 int64_t atomic_add_fetch_64(int64_t volatile* ptr, int64_t val) {
@@ -116,3 +126,234 @@ int setConsoleEcho(bool on) {
     return 0;
 }
 
+static int32_t  g_toolsAffinity = TOOLS_AFFINITY_NONE;
+static int32_t *g_toolsCpuList = NULL;
+static int32_t  g_toolsCpuListLen = 0;
+
+// parse a cpu list such as "0-3,8,10-11" into cpus, returns the count
+// or -1 when the list is malformed
+static int32_t toolsParseCpuList(const char *spec, int32_t *cpus,
+                                 int32_t size) {
+    int32_t     count = 0;
+    const char *p = spec;
+    while (*p) {
+        char *end;
+        long  from = strtol(p, &end, 10);
+        long  to = from;
+        if (end == p || from < 0) {
+            return -1;
+        }
+        p = end;
+        if ('-' == *p) {
+            to = strtol(p + 1, &end, 10);
+            if (end == p + 1 || to < from) {
+                return -1;
+            }
+            p = end;
+        }
+        if (to >= TOOLS_MAX_CPUS) {
+            return -1;
+        }
+        for (long c = from; c <= to; c++) {
+            if (count >= size) {
+                return -1;
+            }
+            cpus[count++] = (int32_t)c;
+        }
+        if (',' == *p) {
+            p++;
+        } else if (*p) {
+            return -1;
+        }
+    }
+    return count;
+}
+
+int32_t toolsSetAffinity(const char *spec) {
+    if (0 == strcasecmp(spec, "none")) {
+        g_toolsAffinity = TOOLS_AFFINITY_NONE;
+    } else if (0 == strcasecmp(spec, "compact")) {
+        g_toolsAffinity = TOOLS_AFFINITY_COMPACT;
+    } else if (0 == strcasecmp(spec, "scatter")) {
+        g_toolsAffinity = TOOLS_AFFINITY_SCATTER;
+    } else if (0 == strcasecmp(spec, "numa")) {
+        g_toolsAffinity = TOOLS_AFFINITY_NUMA;
+    } else {
+        int32_t *cpus = calloc(TOOLS_MAX_CPUS, sizeof(int32_t));
+        int32_t  count = cpus
+            ? toolsParseCpuList(spec, cpus, TOOLS_MAX_CPUS) : -1;
+        if (count <= 0) {
+            free(cpus);
+            return -1;
+        }
+        free(g_toolsCpuList);
+        g_toolsCpuList = cpus;
+        g_toolsCpuListLen = count;
+        g_toolsAffinity = TOOLS_AFFINITY_LIST;
+    }
+    return 0;
+}
+
+#ifdef LINUX
+// policy values of mbind(2), numaif.h is not always installed
+#define TOOLS_MPOL_PREFERRED    1
+#define TOOLS_MPOL_MF_MOVE      (1 << 1)
+
+static pthread_once_t  g_toolsTopoOnce = PTHREAD_ONCE_INIT;
+// cpus this process may run on, ordered by numa node and then by id
+static int32_t         g_toolsCpus[TOOLS_MAX_CPUS];
+static int32_t         g_toolsCpuCount = 0;
+static int16_t         g_toolsCpuNode[TOOLS_MAX_CPUS];
+// nodes that own at least one of those cpus, as ranges of g_toolsCpus
+static int32_t         g_toolsNodeId[TOOLS_MAX_NODES];
+static int32_t         g_toolsNodeFirst[TOOLS_MAX_NODES];
+static int32_t         g_toolsNodeCpus[TOOLS_MAX_NODES];
+static int32_t         g_toolsNodes = 0;
+static __thread int32_t t_toolsNode = -1;
+
+static void toolsLoadTopology() {
+    int32_t *cpus = calloc(TOOLS_MAX_CPUS, sizeof(int32_t));
+    if (NULL == cpus) {
+        return;
+    }
+    // without sysfs every cpu is on node 0
+    memset(g_toolsCpuNode, 0, sizeof(g_toolsCpuNode));
+    for (int32_t n = 0; n < TOOLS_MAX_NODES; n++) {
+        char path[64];
+        char list[4096];
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/node/node%d/cpulist", n);
+        FILE *fp = fopen(path, "r");
+        if (NULL == fp) {
+            continue;
+        }
+        if (fgets(list, sizeof(list), fp)) {
+            list[strcspn(list, "\r\n")] = '\0';
+            int32_t count = toolsParseCpuList(list, cpus, TOOLS_MAX_CPUS);
+            for (int32_t i = 0; i < count; i++) {
+                g_toolsCpuNode[cpus[i]] = (int16_t)n;
+            }
+        }
+        fclose(fp);
+    }
+    free(cpus);
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed)) {
+        return;
+    }
+    for (int32_t n = 0; n < TOOLS_MAX_NODES; n++) {
+        int32_t first = g_toolsCpuCount;
+        for (int32_t c = 0; c < TOOLS_MAX_CPUS; c++) {
+            if (CPU_ISSET(c, &allowed) && g_toolsCpuNode[c] == n) {
+                g_toolsCpus[g_toolsCpuCount++] = c;
+            }
+        }
+        if (g_toolsCpuCount > first) {
+            g_toolsNodeId[g_toolsNodes] = n;
+            g_toolsNodeFirst[g_toolsNodes] = first;
+            g_toolsNodeCpus[g_toolsNodes] = g_toolsCpuCount - first;
+            g_toolsNodes++;
+        }
+    }
+}
+#endif
+
+// pin the calling thread, the seq-th worker, according to the policy.
+// compact fills the cpus of one node before the next, scatter deals
+// threads round robin over the nodes, numa binds a thread to all cpus
+// of a node, and a list uses the given cpus in turn
+int32_t toolsBindThread(int32_t seq) {
+#ifdef LINUX
+    if (TOOLS_AFFINITY_NONE == g_toolsAffinity || seq < 0) {
+        return 0;
+    }
+    pthread_once(&g_toolsTopoOnce, toolsLoadTopology);
+    if (0 == g_toolsCpuCount) {
+        return -1;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    int32_t   node = -1;
+    switch (g_toolsAffinity) {
+        case TOOLS_AFFINITY_LIST: {
+            int32_t cpu = g_toolsCpuList[seq % g_toolsCpuListLen];
+            CPU_SET(cpu, &set);
+            node = g_toolsCpuNode[cpu];
+            break;
+        }
+        case TOOLS_AFFINITY_COMPACT: {
+            int32_t cpu = g_toolsCpus[seq % g_toolsCpuCount];
+            CPU_SET(cpu, &set);
+            node = g_toolsCpuNode[cpu];
+            break;
+        }
+        case TOOLS_AFFINITY_SCATTER: {
+            int32_t n = seq % g_toolsNodes;
+            int32_t k = (seq / g_toolsNodes) % g_toolsNodeCpus[n];
+            CPU_SET(g_toolsCpus[g_toolsNodeFirst[n] + k], &set);
+            node = g_toolsNodeId[n];
+            break;
+        }
+        default: {
+            int32_t n = seq % g_toolsNodes;
+            for (int32_t k = 0; k < g_toolsNodeCpus[n]; k++) {
+                CPU_SET(g_toolsCpus[g_toolsNodeFirst[n] + k], &set);
+            }
+            node = g_toolsNodeId[n];
+            break;
+        }
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+        return -1;
+    }
+    t_toolsNode = node;
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+int32_t toolsThreadNode() {
+#ifdef LINUX
+    return t_toolsNode;
+#else
+    return -1;
+#endif
+}
+
+int32_t toolsNumaNodes() {
+#ifdef LINUX
+    if (TOOLS_AFFINITY_NONE == g_toolsAffinity) {
+        return 1;
+    }
+    pthread_once(&g_toolsTopoOnce, toolsLoadTopology);
+    return g_toolsNodes > 0 ? g_toolsNodes : 1;
+#else
+    return 1;
+#endif
+}
+
+// migrate the pages fully inside [ptr, ptr + len) to the node of the
+// calling thread, for buffers allocated before the thread was placed
+void toolsMoveToLocalNode(void *ptr, size_t len) {
+#if defined(LINUX) && defined(__NR_mbind)
+    if (t_toolsNode < 0 || toolsNumaNodes() < 2 || NULL == ptr) {
+        return;
+    }
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t begin = ((uintptr_t)ptr + page - 1) & ~(page - 1);
+    uintptr_t end = ((uintptr_t)ptr + len) & ~(page - 1);
+    if (end <= begin) {
+        return;
+    }
+    unsigned long mask[TOOLS_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+    mask[t_toolsNode / (8 * sizeof(unsigned long))] |=
+        1UL << (t_toolsNode % (8 * sizeof(unsigned long)));
+    // best effort, memory that cannot move simply stays where it is
+    (void)syscall(__NR_mbind, begin, end - begin, TOOLS_MPOL_PREFERRED,
+                  mask, TOOLS_MAX_NODES + 1, TOOLS_MPOL_MF_MOVE);
+#endif
+}
@@ -0,0 +1,90 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+import re
+import subprocess
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # the delay summary comes from the latency histogram, its
+        # percentiles must be ordered and within [min, max]
+        cmd = "%s -t 2 -n 10000 -r 10 -y 2>&1 | grep 'insert delay'" % binPath
+        tdLog.info("%s" % cmd)
+        output = subprocess.check_output(cmd, shell=True).decode("utf-8")
+        tdLog.info("%s" % output)
+        delay = dict(
+            (k, float(v)) for k, v in re.findall(r"([a-z0-9.]+): ([0-9.]+)ms", output)
+        )
+        order = ["min", "p50", "p90", "p95", "p99", "p99.9", "p99.99", "max"]
+        for key in order + ["avg"]:
+            if key not in delay:
+                tdLog.exit("%s missing in %s" % (key, output))
+        for low, high in zip(order, order[1:]):
+            if delay[low] > delay[high]:
+                tdLog.exit("%s %f > %s %f" % (low, delay[low], high, delay[high]))
+        if delay["avg"] < delay["min"] or delay["avg"] > delay["max"]:
+            tdLog.exit("avg %f out of [min, max]" % delay["avg"])
+
+        tdSql.execute("reset query cache")
+        tdSql.query("select count(*) from test.meters")
+        tdSql.checkData(0, 0, 20000)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,87 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+import subprocess
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # worker processes split the tables between them, uneven counts
+        # included, and the coordinator merges their statistics
+        for procs, tables in ((2, 8), (3, 7)):
+            cmd = "%s -Z %d -t %d -T 2 -n 1000 -y 2>&1 | grep 'rows in total'" % (
+                binPath,
+                procs,
+                tables,
+            )
+            tdLog.info("%s" % cmd)
+            output = subprocess.check_output(cmd, shell=True).decode("utf-8")
+            tdLog.info("%s" % output)
+            if ("%d rows in total" % (tables * 1000)) not in output:
+                tdLog.exit("expected %d rows in total, got %s" % (tables * 1000, output))
+            tdSql.execute("reset query cache")
+            tdSql.query("show test.tables")
+            tdSql.checkRows(tables)
+            tdSql.query("select count(*) from test.meters partition by tbname")
+            tdSql.checkRows(tables)
+            for i in range(tables):
+                tdSql.checkData(i, 0, 1000)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,87 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # the same seed must produce the same rows, another seed others
+        sums = {}
+        for db, seed in (("seed1", 42), ("seed2", 42), ("seed3", 43)):
+            cmd = "%s -d %s -X %d -t 4 -n 1000 -M -y" % (binPath, db, seed)
+            tdLog.info("%s" % cmd)
+            os.system("%s" % cmd)
+            tdSql.execute("reset query cache")
+            tdSql.query("select count(*) from %s.meters" % db)
+            tdSql.checkData(0, 0, 4000)
+            tdSql.query(
+                "select sum(voltage), max(current), min(phase), sum(groupid) "
+                "from %s.meters" % db
+            )
+            sums[db] = [tdSql.getData(0, i) for i in range(4)]
+
+        if sums["seed1"] != sums["seed2"]:
+            tdLog.exit(
+                "seed 42 gave %s and %s" % (sums["seed1"], sums["seed2"])
+            )
+        if sums["seed1"] == sums["seed3"]:
+            tdLog.exit("seeds 42 and 43 gave the same rows %s" % sums["seed1"])
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
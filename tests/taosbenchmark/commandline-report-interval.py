@@ -0,0 +1,104 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import json
+import os
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # one json object per interval, the last one written when the
+        # insert ends and counting every row
+        report = "./insert_res_interval.txt.jsonl"
+        if os.path.exists(report):
+            os.remove(report)
+        cmd = "%s -t 2 -n 100000 -j 1 -o ./insert_res_interval.txt -y" % binPath
+        tdLog.info("%s" % cmd)
+        os.system("%s" % cmd)
+
+        if not os.path.exists(report):
+            tdLog.exit("%s not written" % report)
+        with open(report) as f:
+            samples = [json.loads(line) for line in f if line.strip()]
+        if len(samples) == 0:
+            tdLog.exit("%s is empty" % report)
+        rows = 0
+        for sample in samples:
+            for key in ("ts", "elapsed", "rows", "rows_per_sec", "requests",
+                        "errors", "total_rows", "latency_ms"):
+                if key not in sample:
+                    tdLog.exit("%s missing in %s" % (key, sample))
+            for key in ("min", "avg", "p50", "p90", "p99", "p99.9", "max"):
+                if key not in sample["latency_ms"]:
+                    tdLog.exit("latency %s missing in %s" % (key, sample))
+            rows += sample["rows"]
+        if rows != 200000 or samples[-1]["total_rows"] != 200000:
+            tdLog.exit(
+                "expected 200000 rows, intervals sum to %d, last total %d"
+                % (rows, samples[-1]["total_rows"])
+            )
+        if samples[-1]["errors"] != 0:
+            tdLog.exit("errors in %s" % samples[-1])
+        os.remove(report)
+
+        tdSql.execute("reset query cache")
+        tdSql.query("select count(*) from test.meters")
+        tdSql.checkData(0, 0, 200000)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,98 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # 4 threads share one schedule of 2000 rows/s in total, so 6000
+        # rows take about 3 seconds however the tables are spread
+        cmd = "%s -t 5 -T 4 -n 1200 -r 100 -Q 2000 -y" % binPath
+        tdLog.info("%s" % cmd)
+        start = time.time()
+        os.system("%s" % cmd)
+        elapsed = time.time() - start
+        tdLog.info("%d rows at 2000 rows/s took %.2fs" % (6000, elapsed))
+        if elapsed < 2.5:
+            tdLog.exit("target rate not held, took %.2fs" % elapsed)
+        tdSql.execute("reset query cache")
+        tdSql.query("select count(*) from test.meters")
+        tdSql.checkData(0, 0, 6000)
+
+        # a fractional rate is accepted
+        cmd = "%s -t 1 -n 4 -r 1 -Q 2.5 -y" % binPath
+        tdLog.info("%s" % cmd)
+        start = time.time()
+        os.system("%s" % cmd)
+        elapsed = time.time() - start
+        if elapsed < 1.0:
+            tdLog.exit("-Q 2.5 not held, took %.2fs" % elapsed)
+        tdSql.execute("reset query cache")
+        tdSql.query("select count(*) from test.meters")
+        tdSql.checkData(0, 0, 4)
+
+        # anything but a positive number is rejected
+        cmd = "%s -t 1 -n 4 -Q abc -y" % binPath
+        tdLog.info("%s" % cmd)
+        if os.system("%s" % cmd) == 0:
+            tdLog.exit("-Q abc accepted")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
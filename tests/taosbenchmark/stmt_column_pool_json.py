@@ -0,0 +1,101 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # the typed pool is generated once and shared by all threads, the
+        # values must still follow each column's range
+        cmd = "%s -f ./taosbenchmark/json/stmt_column_pool.json" % binPath
+        tdLog.info("%s" % cmd)
+        os.system("%s" % cmd)
+        tdSql.execute("reset query cache")
+        tdSql.query("show db.tables")
+        tdSql.checkRows(16)
+        tdSql.query("select count(*) from db.stb")
+        tdSql.checkData(0, 0, 16000)
+        tdSql.query(
+            "select min(c0), max(c0), min(c1), max(c1), min(c2), max(c2), "
+            "max(length(c3)), max(char_length(c4)), count(distinct c0) "
+            "from db.stb"
+        )
+        if tdSql.getData(0, 0) < 0 or tdSql.getData(0, 1) > 100:
+            tdLog.exit("c0 out of [0, 100]")
+        if tdSql.getData(0, 2) < -10 or tdSql.getData(0, 3) > 10:
+            tdLog.exit("c1 out of [-10, 10]")
+        if tdSql.getData(0, 4) < 1 or tdSql.getData(0, 5) > 2:
+            tdLog.exit("c2 out of [1, 2]")
+        if tdSql.getData(0, 6) > 16 or tdSql.getData(0, 7) > 8:
+            tdLog.exit("c3 or c4 longer than its column")
+        if tdSql.getData(0, 8) < 2:
+            tdLog.exit("c0 has a single value")
+
+        # a csv sample is parsed once into the same pool
+        tdSql.query("select count(*) from db.`stb-c`")
+        tdSql.checkData(0, 0, 160)
+        tdSql.query("select * from db.`stb-c_0`")
+        tdSql.checkRows(20)
+        tdSql.checkData(0, 1, 1)
+        tdSql.checkData(1, 1, 2)
+        tdSql.checkData(2, 1, 3)
+        tdSql.checkData(3, 1, None)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,88 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # the last request of each table is shorter than the ones before,
+        # nothing of the longer requests may be left in the reused buffers
+        cmd = "%s -f ./taosbenchmark/json/taosc_buffer_reuse.json" % binPath
+        tdLog.info("%s" % cmd)
+        os.system("%s" % cmd)
+        tdSql.execute("reset query cache")
+        for stb in ("stb", "stbi", "stbs", "stbr"):
+            tdSql.query("select count(*) from db.%s" % stb)
+            tdSql.checkData(0, 0, 8400)
+        for stb in ("stb", "stbi"):
+            tdSql.query(
+                "select count(*) from db.%s partition by tbname" % stb
+            )
+            tdSql.checkRows(8)
+            for i in range(8):
+                tdSql.checkData(i, 0, 1050)
+            tdSql.query("select min(c0), max(c0) from db.%s" % stb)
+            if tdSql.getData(0, 0) < 0 or tdSql.getData(0, 1) > 100:
+                tdLog.exit("%s c0 out of [0, 100]" % stb)
+            tdSql.query("select max(length(c3)) from db.%s" % stb)
+            if tdSql.getData(0, 0) > 16:
+                tdLog.exit("%s c3 longer than 16" % stb)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,98 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        # the create, insert and stmt phases of both databases take their
+        # connections from one pool, rows must land in the database each
+        # phase selects, not the one a reused connection used last
+        cmd = "%s -f ./taosbenchmark/json/taosc_connection_pool.json" % binPath
+        tdLog.info("%s" % cmd)
+        os.system("%s" % cmd)
+        tdSql.execute("reset query cache")
+        tdSql.query("show db.tables")
+        tdSql.checkRows(32)
+        tdSql.query("select count(*) from db.stb")
+        tdSql.checkData(0, 0, 8000)
+        tdSql.query("select count(*) from db.`stb-s`")
+        tdSql.checkData(0, 0, 8000)
+        tdSql.query("show db2.tables")
+        tdSql.checkRows(8)
+        tdSql.query("select count(*) from db2.stb")
+        tdSql.checkData(0, 0, 2400)
+
+        # the query test warms the same pool and selects db again
+        os.system("rm -f taosc_query_specified-0 taosc_query_super-0")
+        cmd = "%s -f ./taosbenchmark/json/taosc_query.json" % binPath
+        tdLog.info("%s" % cmd)
+        os.system("%s" % cmd)
+        with open("%s" % "taosc_query_specified-0", "r+") as f1:
+            for line in f1.readlines():
+                queryTaosc = line.strip().split()[0]
+                assert queryTaosc == "8000", "result is %s != expect: 8000" % queryTaosc
+
+        with open("%s" % "taosc_query_super-0", "r+") as f1:
+            for line in f1.readlines():
+                queryTaosc = line.strip().split()[0]
+                assert queryTaosc == "500", "result is %s != expect: 500" % queryTaosc
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
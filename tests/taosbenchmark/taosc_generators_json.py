@@ -0,0 +1,104 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+
+        cmd = "%s -f ./taosbenchmark/json/taosc_generators.json" % binPath
+        tdLog.info("%s" % cmd)
+        os.system("%s" % cmd)
+        tdSql.execute("reset query cache")
+        tdSql.query("select count(*) from db.stb")
+        tdSql.checkData(0, 0, 4000)
+
+        # every generated value stays within [min, max] of its column
+        for col, lo, hi in [
+            ("walk", 10, 20),
+            ("wave", -100, 100),
+            ("cnt", 0, 1000),
+            ("rare", 1, 5),
+            ("zipf", 10, 19),
+        ]:
+            tdSql.query("select min(%s), max(%s) from db.stb" % (col, col))
+            if tdSql.getData(0, 0) < lo or tdSql.getData(0, 1) > hi:
+                tdLog.exit(
+                    "%s out of [%d, %d]: %s ~ %s"
+                    % (col, lo, hi, tdSql.getData(0, 0), tdSql.getData(0, 1))
+                )
+
+        # zipf ranks cover at most its categories, the lowest is the
+        # most frequent one
+        tdSql.query("select count(*) from (select distinct zipf from db.stb)")
+        if tdSql.getData(0, 0) > 10:
+            tdLog.exit("zipf drew %s distinct values" % tdSql.getData(0, 0))
+        tdSql.query(
+            "select zipf, count(*) as n from db.stb group by zipf "
+            "order by n desc limit 1"
+        )
+        tdSql.checkData(0, 0, 10)
+        tdSql.query("select count(*) from (select distinct city from db.stb)")
+        if tdSql.getData(0, 0) > 4:
+            tdLog.exit("city drew %s distinct values" % tdSql.getData(0, 0))
+        tdSql.query("select count(*) from db.stb where city not in "
+                    "('bj', 'sh', 'gz', 'sz')")
+        tdSql.checkData(0, 0, 0)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,95 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+import os
+import shutil
+import subprocess
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def caseDescription(self):
+        """
+        [TD-11510] taosBenchmark test cases
+        """
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getPath(self, tool="taosBenchmark"):
+        selfPath = os.path.dirname(os.path.realpath(__file__))
+
+        if "community" in selfPath:
+            projPath = selfPath[: selfPath.find("community")]
+        elif "src" in selfPath:
+            projPath = selfPath[: selfPath.find("src")]
+        elif "/tools/" in selfPath:
+            projPath = selfPath[: selfPath.find("/tools/")]
+        else:
+            projPath = selfPath[: selfPath.find("tests")]
+
+        paths = []
+        for root, dummy, files in os.walk(projPath):
+            if (tool) in files:
+                rootRealPath = os.path.dirname(os.path.realpath(root))
+                if "packaging" not in rootRealPath:
+                    paths.append(os.path.join(root, tool))
+                    break
+        if len(paths) == 0:
+            tdLog.exit("taosBenchmark not found!")
+            return
+        else:
+            tdLog.info("taosBenchmark found in %s" % paths[0])
+            return paths[0]
+
+    def run(self):
+        binPath = self.getPath()
+        cache = "./vgroup_cache/db.stb.vgroups"
+        if os.path.exists("./vgroup_cache"):
+            shutil.rmtree("./vgroup_cache")
+        os.makedirs("./vgroup_cache")
+
+        # the first run resolves the vgroups and saves them. the database
+        # is created again the same way, so the second run loads them, and
+        # a damaged cache is resolved again
+        cmd = (
+            "%s -f ./taosbenchmark/json/taosc_vgroup_cache.json 2>&1 "
+            "| grep 'vgroups of'" % binPath
+        )
+        for expect in ("resolved", "loaded", "resolved"):
+            tdLog.info("%s" % cmd)
+            output = subprocess.check_output(cmd, shell=True).decode("utf-8")
+            tdLog.info("%s" % output)
+            if expect not in output:
+                tdLog.exit("expected vgroups %s, got %s" % (expect, output))
+            if not os.path.exists(cache) or os.path.exists(cache + ".tmp"):
+                tdLog.exit("%s not saved" % cache)
+            tdSql.execute("reset query cache")
+            tdSql.query("select count(*) from db.stb")
+            tdSql.checkData(0, 0, 10000)
+            if "loaded" == expect:
+                with open(cache, "r+b") as f:
+                    f.truncate(os.path.getsize(cache) // 2)
+
+        shutil.rmtree("./vgroup_cache")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())